@@ -0,0 +1,48 @@
+#ifndef MemoryStatisticsProcessor_h
+#define MemoryStatisticsProcessor_h 1
+
+#include "marlin/Processor.h"
+#include "lcio.h"
+#include <string>
+
+using namespace lcio ;
+using namespace marlin ;
+
+//!Report what the memory managers of the LCFI processors hold
+/*!
+<h4>Description</h4>
+Turns on the statistics of the Event and Run MetaMemoryManager in init() and prints them,
+and optionally writes them as comma separated values, in end(). Every LCFI processor labels
+its cleanups with its name, so each processor's objects are counted separately: for each
+type the objects held at the last cleanup, the peak and the mean per cleanup, and how many
+of them were made in the arena by make() rather than allocated and registered.
+<br>The statistics are taken as the other processors clear their objects, the Run objects
+in their end(), so this processor must come after them in the steering file.
+
+\param PrintStatistics If true the statistics are printed as a table at the end
+\param EventStatisticsFile If not empty the statistics of the event lifetime objects are written to this file as comma separated values
+\param RunStatisticsFile If not empty the statistics of the run lifetime objects are written to this file as comma separated values
+*/
+
+class MemoryStatisticsProcessor : public Processor {
+
+ public:
+
+  //The usual Marlin processor methods
+  virtual Processor*  newProcessor() { return new MemoryStatisticsProcessor ; }
+  MemoryStatisticsProcessor() ;
+  MemoryStatisticsProcessor(const MemoryStatisticsProcessor&) = delete;
+  MemoryStatisticsProcessor& operator=(const MemoryStatisticsProcessor&) = delete;
+  virtual void init() ;
+  virtual void processRunHeader( LCRunHeader* run ) ;
+  virtual void processEvent( LCEvent * evt ) ;
+  virtual void check( LCEvent * evt ) ;
+  virtual void end() ;
+
+ protected:
+  bool _PrintStatistics=true;
+  std::string _EventStatisticsFile{};
+  std::string _RunStatisticsFile{};
+} ;
+
+#endif
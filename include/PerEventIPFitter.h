@@ -42,6 +42,7 @@ on a large set of tracks.
 \param DefaultIPPos Length 3 Float Vector of position (x,y,z) returned (as LCIO Vertex) if no fit is found
 \param DefaultIPErr Length 6 Float Vector of covariance (lower symmetric) returned (as LCIO Vertex) if no fit is found 
 \param ProbabilityThreshold Once the vertex is above this probability it is returned
+\param FullRefitInterval Number of tracks trimmed by removing them from the last Kalman fit before the rest are fitted again from scratch, 0 to refit after every track
 
 \author Ben Jeffery (b.jeffery1@physics.ox.ac.uk)
 */
@@ -68,6 +69,7 @@ class PerEventIPFitterProcessor : public Processor {
   FloatVec _DefaultIPPos{};
   FloatVec _DefaultIPErr{};
   double _ProbThreshold=0.0;
+  int _FullRefitInterval=10;
   int _nRun=-1;
   int _nEvt=-1;
 } ;
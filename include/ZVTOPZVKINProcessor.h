@@ -58,6 +58,7 @@ For more details on algorihmic parameters see the ZVKIN paper "zvkin.ps" in the
 \param MinimumProbability  If a vertex candidate has a probability below this it will not be considered - lower value results in more merging and lower vertex multiplicity  
 \param InitialGhostWidth  Width in cm of the ghost inital ghosttrack also the smallest width it is allowed to have  
 \param MaxChi2Allowed  The ghost track is widened until all forward jet tracks have a chi squared lower than this value  
+\param FitCache  If true candidate vertices of a jet refit with the same tracks take the earlier fit rather than fitting again  
 \param OutputTrackChi2  If true the chi squared contributions of tracks to vertices is written to LCIO  
 */
 class ZVTOPZVKINProcessor : public Processor {
@@ -88,6 +89,7 @@ class ZVTOPZVKINProcessor : public Processor {
   double _MinimumProbability=0.0;
   double _InitialGhostWidth=0.0;
   double _MaxChi2Allowed=0.0;
+  bool _FitCache=true;
   bool _OutputTrackChi2=false;
   int _nRun=-1;
   int _nEvt=-1;
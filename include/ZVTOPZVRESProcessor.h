@@ -59,7 +59,17 @@ For more details on algorihmic parameters see the ZVTOP paper.
 \param TwoTrackCut Chi Squared cut for making initial track pairs - chi squared of either track NOT sum
 \param TrackTrimCut Chi Squared cut for final trimming of tracks from vertices
 \param ResolverCut Cut to determine if two vertices are resolved
+\param TubeCullEpsilon Tracks whose gaussian tube is certainly below this at a point are left out of the vertex function there, 0 to always include all
+\param CacheGridSize Vertex function values are remembered per jet for points in the same cell of a grid of this size (mm), 0 for identical points only, negative for no cache
 \param OutputTrackChi2 If true the chi squared contributions of tracks to vertices is written to LCIO
+\param VertexFunctionPrecision DOUBLE, or VALIDATE to also evaluate the vertex function in float and print the largest deviation at the end
+\param Resolver EQUALSTEPS to sample between vertices in order along the line, or BISECTION to sample from the midpoint outwards and stop at the first dip
+\param ResolverSteps Number of steps the line between two vertices is sampled at by the BISECTION resolver
+\param ResolverRefinements Number of refinements about the lowest sample by the BISECTION resolver if no sample dips below the cut
+\param ResolverRadius If positive, vertices further apart than this (mm) are taken as resolved without sampling the vertex function between them. This trades accuracy for speed: radii of 1 mm or less change the track groupings, and no speed-up has been measured
+\param Threads Number of threads making and fitting the 2-prong candidates of each jet, 1 for the serial code, 0 for one per hardware thread
+\param FitCache If true candidate vertices of a jet refit with the same tracks take the earlier fit rather than fitting again, the hits are printed at the end
+\param MaxFinder CLASSICSTEPPER to find vertex function maxima by stepping along each axis, or TRUSTREGION for Newton steps on the analytic derivatives
 */
 class ZVTOPZVRESProcessor : public Processor {
   
@@ -93,7 +103,17 @@ class ZVTOPZVRESProcessor : public Processor {
   double _TwoTrackCut=0.0;
   double _TrackTrimCut=0.0;
   double _ResolverCut=0.0;
+  double _TubeCullEpsilon=0.0;
+  double _CacheGridSize=0.0;
   bool _OutputTrackChi2=false;
+  std::string _VertexFunctionPrecision{};
+  std::string _MaxFinder{};
+  std::string _Resolver{};
+  int _ResolverSteps=0;
+  int _ResolverRefinements=0;
+  double _ResolverRadius=0.0;
+  int _Threads=1;
+  bool _FitCache=true;
   int _nRun=-1;
   int _nEvt=-1;
 } ;
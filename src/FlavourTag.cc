@@ -376,7 +376,7 @@ void FlavourTagProcessor::processEvent( lcio::LCEvent* pEvent )
 	//ofile << "----------------------" << std::endl;
 	}
 	//Clear anything that may have been allocated during this event
-	vertex_lcfi::MetaMemoryManager::Event()->delAllObjects();
+	vertex_lcfi::MetaMemoryManager::Event()->delAllObjects(name());
 }
 
 void FlavourTagProcessor::end
@@ -443,7 +443,7 @@ void FlavourTagProcessor::end
 	//ofile.close();
 	//free up stuff
   
-   vertex_lcfi::MetaMemoryManager::Run()->delAllObjects();
+   vertex_lcfi::MetaMemoryManager::Run()->delAllObjects(name());
 	     
 
 }
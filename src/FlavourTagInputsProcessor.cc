@@ -286,6 +286,8 @@ void FlavourTagInputsProcessor::processRunHeader( LCRunHeader* run) {
 } 
 
 void FlavourTagInputsProcessor::processEvent( LCEvent * evt ) { 
+	//All objects created for this event are cleared when this goes out of scope
+	EventScope Scope(name());
 
   // this gets called for every event 
   // usually the working horse ...
@@ -430,8 +432,6 @@ if( isFirstEvent() )
 	}//End iJet Loop
 	
 	//std::cout << ",";std::cout.flush();
-	//Clear all objects created for this event
-	MetaMemoryManager::Event()->delAllObjects();
 	_nEvt ++ ;
 }
 
@@ -444,7 +444,7 @@ void FlavourTagInputsProcessor::check( LCEvent* ) {
 
 void FlavourTagInputsProcessor::end(){ 
 	
-	MetaMemoryManager::Run()->delAllObjects();
+	MetaMemoryManager::Run()->delAllObjects(name());
    	std::cout << "FlavourTagInputsProcessor::end()  " << name() 
  	    << " processed " << _nEvt << " events in " << _nRun << " runs "
  	    << std::endl ;
@@ -0,0 +1,79 @@
+#include "MemoryStatisticsProcessor.h"
+#include <iostream>
+#include <fstream>
+
+#include <util/inc/memorymanager.h>
+
+#include <string>
+
+using namespace marlin ;
+using namespace lcio;
+using namespace vertex_lcfi;
+
+MemoryStatisticsProcessor aMemoryStatisticsProcessor ;
+
+MemoryStatisticsProcessor::MemoryStatisticsProcessor() : Processor("MemoryStatisticsProcessor") {
+
+  // modify processor description
+  _description = "Prints what the memory managers of the LCFI processors held, place after them" ;
+
+  // register steering parameters: name, description, class-variable, default value
+  registerOptionalParameter( "PrintStatistics" ,
+			      "If true the statistics are printed as a table at the end"  ,
+			      _PrintStatistics,
+			      true) ;
+  registerOptionalParameter( "EventStatisticsFile" ,
+			      "If not empty the statistics of the event lifetime objects are written to this file as comma separated values"  ,
+			      _EventStatisticsFile,
+			      std::string("")) ;
+  registerOptionalParameter( "RunStatisticsFile" ,
+			      "If not empty the statistics of the run lifetime objects are written to this file as comma separated values"  ,
+			      _RunStatisticsFile,
+			      std::string("")) ;
+}
+
+
+void MemoryStatisticsProcessor::init() {
+
+  // usually a good idea to
+  printParameters() ;
+
+  //The managers are per thread, the processors all run on this one
+  MetaMemoryManager::Event()->enableStatistics();
+  MetaMemoryManager::Run()->enableStatistics();
+}
+
+void MemoryStatisticsProcessor::processRunHeader( LCRunHeader* ) {
+}
+
+void MemoryStatisticsProcessor::processEvent( LCEvent * ) {
+}
+
+
+
+void MemoryStatisticsProcessor::check( LCEvent* ) {
+  // nothing to check here - could be used to fill checkplots in reconstruction processor
+}
+
+
+void MemoryStatisticsProcessor::end(){
+
+	if (_PrintStatistics)
+	{
+		std::cout << "Event lifetime objects" << std::endl;
+		MetaMemoryManager::Event()->printStatistics(std::cout);
+		std::cout << "Run lifetime objects" << std::endl;
+		MetaMemoryManager::Run()->printStatistics(std::cout);
+	}
+	if (!_EventStatisticsFile.empty())
+	{
+		std::ofstream StatsFile(_EventStatisticsFile.c_str());
+		MetaMemoryManager::Event()->writeStatistics(StatsFile);
+	}
+	if (!_RunStatisticsFile.empty())
+	{
+		std::ofstream StatsFile(_RunStatisticsFile.c_str());
+		MetaMemoryManager::Run()->writeStatistics(StatsFile);
+	}
+}
+
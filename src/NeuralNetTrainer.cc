@@ -364,7 +364,7 @@ void NeuralNetTrainerProcessor::processEvent( lcio::LCEvent* pEvent )
 	++_nEvent;
 
 	//Clear anything that may have been allocated during this event
-	vertex_lcfi::MetaMemoryManager::Event()->delAllObjects();
+	vertex_lcfi::MetaMemoryManager::Event()->delAllObjects(name());
 }
 
 /*
@@ -488,7 +488,7 @@ void NeuralNetTrainerProcessor::end()
 	std::cout << "Finished training all selected nets" << std::endl;
 	
 	//free up stuff
-	vertex_lcfi::MetaMemoryManager::Run()->delAllObjects();
+	vertex_lcfi::MetaMemoryManager::Run()->delAllObjects(name());
 }
 
 void NeuralNetTrainerProcessor::_trainNet( nnet::BackPropagationCGAlgorithm& backPropCGAlgo, nnet::NeuralNetDataSet& dataSet )
@@ -64,6 +64,10 @@ PerEventIPFitterProcessor::PerEventIPFitterProcessor() : Processor("PerEventIPFi
 			      "Tracks are removed until this threshold is reached"  ,
 			      _ProbThreshold ,
 			      double(0.01)) ;
+  registerOptionalParameter( "FullRefitInterval" , 
+			      "Tracks trimmed by taking them out of the last fit before the remaining tracks are fitted from scratch, 0 to fit from scratch after every track"  ,
+			      _FullRefitInterval,
+			      int(10)) ;
 }
 
 
@@ -80,6 +84,7 @@ void PerEventIPFitterProcessor::init() {
   MemoryManager<Algo<Event*,vertex_lcfi::Vertex*> >::Run()->registerObject(_IPFitter);
   
   _IPFitter->setDoubleParameter("ProbThreshold",_ProbThreshold);
+  _IPFitter->setDoubleParameter("FullRefitInterval",double(_FullRefitInterval));
 }
 
 void PerEventIPFitterProcessor::processRunHeader( LCRunHeader* ) {
@@ -134,7 +139,7 @@ void PerEventIPFitterProcessor::processEvent( LCEvent * evt ) {
 	evt->getCollection(_VertexCollectionName)->addElement(LCIOIPResult);
 
 	//Clear all objects created for this event
-	MetaMemoryManager::Event()->delAllObjects();
+	MetaMemoryManager::Event()->delAllObjects(name());
 	_nEvt ++ ;
 }
 
@@ -147,7 +152,7 @@ void PerEventIPFitterProcessor::check( LCEvent* ) {
 
 void PerEventIPFitterProcessor::end(){ 
   
-	MetaMemoryManager::Run()->delAllObjects();
+	MetaMemoryManager::Run()->delAllObjects(name());
    	std::cout << "PerEventIPFitterProcessor::end()  " << name() 
  	    << " processed " << _nEvt << " events in " << _nRun << " runs "
  	    << std::endl ;
@@ -431,7 +431,7 @@ void RPCutProcessor::processEvent( LCEvent * evt ) {
 		}				     
 	}
 	//Clear all objects created
-	vertex_lcfi::MetaMemoryManager::Event()->delAllObjects();
+	vertex_lcfi::MetaMemoryManager::Event()->delAllObjects(name());
 	_nEvt ++ ;
 }
 
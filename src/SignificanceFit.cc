@@ -241,7 +241,7 @@ void SignificanceFit::processEvent( LCEvent* )
 	      }
 
 	  }
-	MetaMemoryManager::Event()->delAllObjects();
+	MetaMemoryManager::Event()->delAllObjects(name());
 #endif	  
 
 	_nEvt++;
@@ -483,7 +483,7 @@ void SignificanceFit::end(){
       std::cout<<zoutPars[i]<<std::endl;
     }
 
-  MetaMemoryManager::Run()->delAllObjects();
+  MetaMemoryManager::Run()->delAllObjects(name());
 
 #endif	  
   std::cout << "SignificanceFitProcessor::end()  " << name() 
@@ -214,7 +214,7 @@ if( isFirstEvent() )
 	
 	//std::cout << ",";std::cout.flush();
 	//Clear all objects created for this event
-	MetaMemoryManager::Event()->delAllObjects();
+	MetaMemoryManager::Event()->delAllObjects(name());
 	_nEvt ++ ;
 }
 
@@ -227,7 +227,7 @@ void VertexChargeProcessor::check( LCEvent* ) {
 
 void VertexChargeProcessor::end(){ 
 	
-	MetaMemoryManager::Run()->delAllObjects();
+	MetaMemoryManager::Run()->delAllObjects(name());
    	std::cout << "VertexChargeProcessor::end()  " << name() 
  	    << " processed " << _nEvt << " events in " << _nRun << " runs "
  	    << std::endl ;
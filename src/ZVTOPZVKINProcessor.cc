@@ -97,6 +97,10 @@ ZVTOPZVKINProcessor::ZVTOPZVKINProcessor() : Processor("ZVTOP_ZVKINProcessor") {
 			      "The ghost track is widened until all forward jet tracks have a chi squared lower than this value"  ,
 			      _MaxChi2Allowed,
 			      double(1.0)) ;
+  registerOptionalParameter( "FitCache" , 
+			      "If true candidate vertices of a jet refit with the same tracks take the earlier fit rather than fitting again"  ,
+			      _FitCache,
+			      true) ;
   registerOptionalParameter( "OutputTrackChi2" , 
 			      "If true the chi squared contributions of tracks to vertices is written to LCIO"  ,
 			      _OutputTrackChi2,
@@ -121,6 +125,7 @@ void ZVTOPZVKINProcessor::init() {
   _ZVKIN->setDoubleParameter("MaxChi2Allowed",_MaxChi2Allowed);
   _ZVKIN->setStringParameter("AutoJetAxis","TRUE");
   _ZVKIN->setStringParameter("UseEventIP","TRUE");
+  _ZVKIN->setStringParameter("FitCache",_FitCache ? "TRUE" : "FALSE");
 	
 }
 
@@ -220,7 +225,7 @@ void ZVTOPZVKINProcessor::processEvent( LCEvent * evt ) {
 		*/
 	}
 	//Clear all objects created for this event
-	MetaMemoryManager::Event()->delAllObjects();
+	MetaMemoryManager::Event()->delAllObjects(name());
 	_nEvt ++ ;
 }
 
@@ -233,7 +238,7 @@ void ZVTOPZVKINProcessor::check( LCEvent* ) {
 
 void ZVTOPZVKINProcessor::end(){ 
   
-	MetaMemoryManager::Run()->delAllObjects();
+	MetaMemoryManager::Run()->delAllObjects(name());
    	std::cout << "ZVTOPZVKINProcessor::end()  " << name() 
  	    << " processed " << _nEvt << " events in " << _nRun << " runs "
  	    << std::endl ;
@@ -10,6 +10,8 @@
 
 #include <util/inc/memorymanager.h>
 #include <algo/inc/zvres.h>
+#include <zvtop/include/vertexfunctionclassic.h>
+#include <zvtop/include/vertexfitcache.h>
 #include <util/inc/matrix.h>
 #include <inc/lciointerface.h>
 
@@ -105,10 +107,50 @@ ZVTOPZVRESProcessor::ZVTOPZVRESProcessor() : Processor("ZVTOP_ZVRESProcessor") {
 			      "Cut to determine if two vertices are resolved"  ,
 			      _ResolverCut,
 			      double(0.6)) ;
+  registerOptionalParameter( "TubeCullEpsilon" , 
+			      "Tracks whose gaussian tube is certainly below this at a point are left out of the vertex function there, 0 to always include all"  ,
+			      _TubeCullEpsilon,
+			      double(1e-12)) ;
+  registerOptionalParameter( "CacheGridSize" , 
+			      "Vertex function values are remembered per jet for points in the same cell of a grid of this size (mm), 0 for identical points only, negative for no cache"  ,
+			      _CacheGridSize,
+			      double(0.0)) ;
   registerOptionalParameter( "OutputTrackChi2" , 
 			      "If true the chi squared contributions of tracks to vertices is written to LCIO"  ,
 			      _OutputTrackChi2,
 			      false) ;
+  registerOptionalParameter( "VertexFunctionPrecision" , 
+			      "DOUBLE, or VALIDATE to also evaluate the vertex function in float and print the largest deviation at the end"  ,
+			      _VertexFunctionPrecision,
+			      std::string("DOUBLE")) ;
+  registerOptionalParameter( "MaxFinder" , 
+			      "CLASSICSTEPPER to find vertex function maxima by stepping along each axis, or TRUSTREGION for Newton steps on the analytic derivatives"  ,
+			      _MaxFinder,
+			      std::string("CLASSICSTEPPER")) ;
+  registerOptionalParameter( "Resolver" , 
+			      "EQUALSTEPS to sample between vertices in order along the line, or BISECTION to sample from the midpoint outwards and stop at the first dip"  ,
+			      _Resolver,
+			      std::string("BISECTION")) ;
+  registerOptionalParameter( "ResolverSteps" , 
+			      "Number of steps the line between two vertices is sampled at by the BISECTION resolver"  ,
+			      _ResolverSteps,
+			      int(10)) ;
+  registerOptionalParameter( "ResolverRefinements" , 
+			      "Number of refinements about the lowest sample by the BISECTION resolver if no sample dips below the cut"  ,
+			      _ResolverRefinements,
+			      int(0)) ;
+  registerOptionalParameter( "ResolverRadius" , 
+			      "If positive, vertices further apart than this (mm) are taken as resolved without sampling the vertex function between them. This trades accuracy for speed: radii of 1 mm or less change the track groupings, and no speed-up has been measured"  ,
+			      _ResolverRadius,
+			      double(0.0)) ;
+  registerOptionalParameter( "Threads" , 
+			      "Number of threads making and fitting the 2-prong candidates of each jet, 1 for the serial code, 0 for one per hardware thread"  ,
+			      _Threads,
+			      int(1)) ;
+  registerOptionalParameter( "FitCache" , 
+			      "If true candidate vertices of a jet refit with the same tracks take the earlier fit rather than fitting again"  ,
+			      _FitCache,
+			      true) ;
 
 }
 
@@ -130,9 +172,19 @@ void ZVTOPZVRESProcessor::init() {
   _ZVRES->setDoubleParameter("TwoProngCut",_TwoTrackCut);
   _ZVRES->setDoubleParameter("TrackTrimCut",_TrackTrimCut);
   _ZVRES->setDoubleParameter("ResolverCut",_ResolverCut);
+  _ZVRES->setDoubleParameter("TubeCullEpsilon",_TubeCullEpsilon);
+  _ZVRES->setDoubleParameter("CacheGridSize",_CacheGridSize);
   _ZVRES->setStringParameter("AutoJetAxis","TRUE");
   _ZVRES->setStringParameter("UseEventIP","TRUE");
-	
+  _ZVRES->setStringParameter("VertexFunctionPrecision",_VertexFunctionPrecision);
+  _ZVRES->setStringParameter("MaxFinder",_MaxFinder);
+  _ZVRES->setStringParameter("Resolver",_Resolver);
+  _ZVRES->setDoubleParameter("ResolverSteps",double(_ResolverSteps));
+  _ZVRES->setDoubleParameter("ResolverRefinements",double(_ResolverRefinements));
+  _ZVRES->setDoubleParameter("ResolverRadius",_ResolverRadius);
+  _ZVRES->setDoubleParameter("Threads",double(_Threads));
+  _ZVRES->setStringParameter("FitCache",_FitCache ? "TRUE" : "FALSE");
+  
 }
 
 void ZVTOPZVRESProcessor::processRunHeader( LCRunHeader* ) {
@@ -140,6 +192,8 @@ void ZVTOPZVRESProcessor::processRunHeader( LCRunHeader* ) {
 } 
 
 void ZVTOPZVRESProcessor::processEvent( LCEvent * evt ) { 
+	//All objects created for this event are cleared when this goes out of scope
+	EventScope Scope(name());
 	//Make Event from 
 	LCCollection* JetCollection;
 	JetCollection = evt->getCollection( _JetRPCollectionName );
@@ -234,9 +288,7 @@ void ZVTOPZVRESProcessor::processEvent( LCEvent * evt ) {
 		evt->getCollection(_RelationCollectionName)->addElement(NewRelation);
 		*/
 	}
-	//Clear all objects created for this event
 	std::cout << ",";std::cout.flush();
-	MetaMemoryManager::Event()->delAllObjects();
 	_nEvt ++ ;
 }
 
@@ -249,7 +301,27 @@ void ZVTOPZVRESProcessor::check( LCEvent* ) {
 
 void ZVTOPZVRESProcessor::end(){ 
   
-	MetaMemoryManager::Run()->delAllObjects();
+	if (_VertexFunctionPrecision == "VALIDATE")
+	{
+		//Merged over the threads that evaluated
+		const ZVTOP::PrecisionValidation Validation = ZVTOP::VertexFunctionClassic::precisionValidation();
+		std::cout << "Vertex function single precision validation over " << Validation.Evaluations << " evaluations:"
+			  << " max absolute deviation " << Validation.MaxAbsDeviation
+			  << ", max relative deviation " << Validation.MaxRelDeviation
+			  << ", " << Validation.ThresholdDisagreements << " disagreements on the 0.001 cut" << std::endl;
+	}
+	if (_CacheGridSize >= 0.0)
+	{
+		const ZVTOP::CacheStatistics & Statistics = ZVTOP::VertexFunctionClassic::cacheStatistics();
+		std::cout << "Vertex function cache " << Statistics.Hits << " hits, " << Statistics.Misses << " misses" << std::endl;
+	}
+	if (_FitCache)
+	{
+		//The caches add to the statistics as the event objects are deleted
+		const ZVTOP::FitCacheStatistics & Statistics = ZVTOP::VertexFitCache::cacheStatistics();
+		std::cout << "Vertex fit cache " << Statistics.Hits << " hits, " << Statistics.Misses << " misses" << std::endl;
+	}
+	MetaMemoryManager::Run()->delAllObjects(name());
    	std::cout << "ZVTOPZVRESProcessor::end()  " << name() 
  	    << " processed " << _nEvt << " events in " << _nRun << " runs "
  	    << std::endl ;
@@ -80,6 +80,7 @@ namespace vertex_lcfi
 	private:
 		std::string _Name{};
 		double _ProbThreshold=0.0;		
+		double _FullRefitInterval=0.0;
 	};
 
 	}
@@ -85,6 +85,7 @@ namespace vertex_lcfi
 	private:
 		bool _UseEventIP=false;
 		bool _AutoJetAxis=false;
+		bool _FitCache=true;
 		Vector3 _JetAxis{};
 		double _MinimumProbability=0.0;
 		double _InitialGhostWidth=0.0;
@@ -6,6 +6,9 @@
 #include <string>
 #include <vector>
 #include <util/inc/vector3.h>
+#include <zvtop/include/vertexfunction.h>
+#include <zvtop/include/vertexfuncmaxfinder.h>
+#include <zvtop/include/vertexresolver.h>
 
 using std::string;
 
@@ -83,8 +86,12 @@ namespace vertex_lcfi
 		DecayChain* calculateFor(Jet* MyJet) const;
 		
 	private:
-		double _Kip,_Kalpha,_TwoProngCut,_TrackTrimCut,_ResolverCut;
-		bool _AutoJetAxis,_UseEventIP;
+		double _Kip,_Kalpha,_TwoProngCut,_TrackTrimCut,_ResolverCut,_TubeCullEpsilon,_CacheGridSize;
+		double _ResolverSteps,_ResolverRefinements,_ResolverRadius,_Threads;
+		bool _AutoJetAxis,_UseEventIP,_FitCache;
+		ZVTOP::VertexFunctionPrecision _VertexFunctionPrecision;
+		ZVTOP::VertexFuncMaxFinderType _MaxFinder;
+		ZVTOP::VertexResolverType _Resolver;
 		Vector3 _JetAxis{};
 	};
 }
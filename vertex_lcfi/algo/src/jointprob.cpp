@@ -1,6 +1,7 @@
 #include <algo/inc/jointprob.h>
 #include <inc/track.h>
 #include <inc/jet.h>
+#include <inc/trackbatch.h>
 #include <util/inc/helixrep.h>
 #include <util/inc/projection.h>
 #include <vector>
@@ -145,13 +146,22 @@ namespace vertex_lcfi
     
 
      
+    //series of cuts
+    std::vector<Track*> Selected;
     for (std::vector<Track*>::const_iterator iTrack= (MyJet->tracks().begin()); iTrack != (MyJet->tracks().end()) ;++iTrack)
       {
-	//series of cuts
-	
 	if( fabs( (*iTrack)->helixRep().d0() )< maxdz  && fabs( (*iTrack)->helixRep().z0() ) < maxdz  )
-	  {
-	    
+	  Selected.push_back(*iTrack);
+      }
+
+    //d0 and z0 significances for all selected tracks at once
+    TrackBatch Batch(Selected);
+    std::vector<double> SignificanceRPhi(Batch.size());
+    std::vector<double> SignificanceZ(Batch.size());
+    Batch.significances(SignificanceRPhi.data(), SignificanceZ.data());
+
+    for (std::size_t iTrack = 0; iTrack < Batch.size(); ++iTrack)
+      {
 	    //(d0,z0,3-d)
 	    for(j = 0; j<3; j++ )
 	      {
@@ -159,18 +169,18 @@ namespace vertex_lcfi
 		{
 		case 0:
 		  {
-		    significancecompare =  fabs((*iTrack)->significance(RPhi));
+		    significancecompare =  fabs(SignificanceRPhi[iTrack]);
 		    break;
 		  }
 		case 1:
 		  {
-		    significancecompare =  fabs((*iTrack)->significance( Z/*,MyJet->momentum()*/  ));
+		    significancecompare =  fabs(SignificanceZ[iTrack]);
 
 		    break;
 		  }
 		case 2:
 		  {
-		   significancecompare = fabs((*iTrack)->significance(ThreeD));
+		   significancecompare = fabs(Batch.track(iTrack)->significance(ThreeD));
 		   break;
 		  }
 		} 
@@ -185,7 +195,6 @@ namespace vertex_lcfi
 		    ntraks[j]++;
 		  }
 	      }
-	  }
       }
     
 
@@ -3,6 +3,7 @@
 #include <inc/event.h>
 #include <inc/trackstate.h>
 #include <inc/jet.h>
+#include <inc/trackbatch.h>
 #include <util/inc/helixrep.h>
 #include <util/inc/projection.h>
 #include <util/inc/string.h>
@@ -101,6 +102,7 @@ namespace vertex_lcfi
     double mommin5 = _AllLayersMomentumCut;
     std::map<SignificanceType,double> ResultMap;
  
+    std::vector<Track*> Selected;
     for (std::vector<Track*>::const_iterator iTrack= (MyJet->tracks().begin()); iTrack != (MyJet->tracks().end()) ;++iTrack)
       {
 	momentum =  (*iTrack)->momentum().mag();
@@ -115,30 +117,38 @@ namespace vertex_lcfi
 	    
 	    
 	    if(iTrack3 == (*_TwoTrackPidCut)[KShort].end() && iTrack2 == (*_TwoTrackPidCut)[Gamma].end() )
-	      {
-		double d0significance =  (*iTrack)->signedSignificance(RPhi,MyJet);
-		double z0significance =  (*iTrack)->signedSignificance(Z,MyJet);
-	
-		if (d0significance > maxsig)
-		  {
-		    maxsig2 = maxsig;
-		    maxmom2 = maxmom;
-		    maxz02  = maxz0;
-		    maxsig = d0significance;
-		    maxmom = momentum;
-		    maxz0  = z0significance;
-		  }
-		else if(d0significance > maxsig2)
-		  {
-		    maxsig2 = d0significance;
-		    maxmom2 = momentum;
-		    maxz02  = z0significance;
-		  }
-		
-	      }
-	    
+	      Selected.push_back(*iTrack);
 	  } 
       }
+
+    //Signed d0 and z0 significances for all selected tracks at once
+    TrackBatch Batch(Selected);
+    std::vector<double> D0Significance(Batch.size());
+    std::vector<double> Z0Significance(Batch.size());
+    Batch.signedSignificances(MyJet->momentum(), D0Significance.data(), Z0Significance.data());
+
+    for (std::size_t iTrack = 0; iTrack < Batch.size(); ++iTrack)
+      {
+	momentum =  Batch.track(iTrack)->momentum().mag();
+	double d0significance =  D0Significance[iTrack];
+	double z0significance =  Z0Significance[iTrack];
+	
+	if (d0significance > maxsig)
+	  {
+	    maxsig2 = maxsig;
+	    maxmom2 = maxmom;
+	    maxz02  = maxz0;
+	    maxsig = d0significance;
+	    maxmom = momentum;
+	    maxz0  = z0significance;
+	  }
+	else if(d0significance > maxsig2)
+	  {
+	    maxsig2 = d0significance;
+	    maxmom2 = momentum;
+	    maxz02  = z0significance;
+	  }
+      }
     
     ResultMap[D0SigTrack1] =  maxsig;
     ResultMap[D0SigTrack2] =  maxsig2;
@@ -26,6 +26,7 @@ namespace vertex_lcfi
 	PerEventIPFitter::PerEventIPFitter()
 	{
 		_ProbThreshold = 0.01;
+		_FullRefitInterval = 10.0;
 	}
 	
 	string PerEventIPFitter::name() const
@@ -37,6 +38,7 @@ namespace vertex_lcfi
 	{
 		std::vector<string> paramNames;
 		paramNames.push_back("ProbThreshold");
+		paramNames.push_back("FullRefitInterval");
 		return paramNames;
 	}
 	
@@ -44,6 +46,7 @@ namespace vertex_lcfi
 	{
 		std::vector<string> paramValues;
 		paramValues.push_back(makeString(_ProbThreshold));
+		paramValues.push_back(makeString(_FullRefitInterval));
 		return paramValues;
 	}	
 	
@@ -58,6 +61,10 @@ namespace vertex_lcfi
 		{
 			_ProbThreshold = Value;
 		}
+		else if (Parameter == "FullRefitInterval")
+		{
+			_FullRefitInterval = Value;
+		}
 		else this->badParameter(Parameter);
 	}		
 	
@@ -69,15 +76,20 @@ namespace vertex_lcfi
 	Vertex* PerEventIPFitter::calculateFor(Event* MyEvent) const
 	{
 		//TODO Check for default IP and throw if none
-		//Make trackstates for use by CandidateVertex object
+		//Make trackstates for use by CandidateVertex object, they only need to last as long as it does
+		vector<TrackState> States;
+		States.reserve(MyEvent->tracks().size());
 		vector<TrackState*> TrackStates;
 		for (vector<Track*>::const_iterator iTrack  = MyEvent->tracks().begin(); iTrack != MyEvent->tracks().end(); ++iTrack)
 		{
-			TrackStates.push_back((*iTrack)->makeState());
+			States.push_back((*iTrack)->state());
+			TrackStates.push_back(&States.back());
 		}
 		
 		VertexFitterKalman MyFitter;
 		MyFitter.setSeed(MyEvent->interactionPoint());
+		//Trimming takes tracks out of the fit, fitting from scratch every so often
+		MyFitter.setFullRefitInterval((int)_FullRefitInterval);
 		// MyFitter.setInitialStep(1.0/1000.0);
 		
 		CandidateVertex CVertex(TrackStates, /*VertexFunction*/ 0, &MyFitter);
@@ -90,11 +102,11 @@ namespace vertex_lcfi
 		//Check that we have 2 or more tracks, if not return default
 		if (CVertex.trackStateList().size() >= 2) 
 		{
-			ResultVertex = new Vertex(&CVertex,MyEvent);
+			ResultVertex = MemoryManager<Vertex>::Event()->make(&CVertex,MyEvent);
 		}
 		else
 		{
-			ResultVertex = new Vertex(MyEvent,
+			ResultVertex = MemoryManager<Vertex>::Event()->make(MyEvent,
 						  vector<Track*>(),
 						  MyEvent->interactionPoint(),
 						  MyEvent->interactionPointError(),
@@ -104,7 +116,6 @@ namespace vertex_lcfi
 		}
 		
 		ResultVertex->isPrimary()=true;
-		MemoryManager<Vertex>::Event()->registerObject(ResultVertex);
 		return ResultVertex;		
 	}
 }
@@ -83,11 +83,14 @@ namespace vertex_lcfi
     double ndf;
     double ntrk;
     InteractionPoint* IP = 0;
+    std::vector< TrackState > States;
+    States.reserve(MyDecayChain->allTracks().size());
     std::vector< TrackState* > AllTrackStates;
 
     for (std::vector<Track*>::const_iterator iTrack = (MyDecayChain->allTracks().begin()); iTrack != MyDecayChain->allTracks().end() ;++iTrack)
       {
-	AllTrackStates.push_back( (**iTrack).makeState() );
+	States.push_back( (**iTrack).state() );
+	AllTrackStates.push_back( &States.back() );
       }
     // fit vertex
     VertexFitterLSM Fitter;
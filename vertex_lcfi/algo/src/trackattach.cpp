@@ -103,8 +103,7 @@ namespace vertex_lcfi
     int numberoftracks = 0;
     int  vertexcounter = 0;
     int tempvertex =0;
-    DecayChain* DecaywithAtTracks = new DecayChain(*MyDecayChain);
-    MemoryManager<DecayChain> ::Event()->registerObject(DecaywithAtTracks);
+    DecayChain* DecaywithAtTracks = MemoryManager<DecayChain>::Event()->make(*MyDecayChain);
     std::vector<vertex_lcfi::Track > AttachedTracks;
     std::vector<Track*> Innertracks;
     
@@ -154,8 +153,7 @@ namespace vertex_lcfi
 	
 	Track LinearTrack(0,LinearHelix,mom,0.0,dummy,std::vector<int>());	
 	
-	TrackState* TSLin = LinearTrack.makeState();
-	TrackState* TSHel;
+	TrackState TSLin = LinearTrack.state();
 
 
 	for (std::vector<Track*>::const_iterator iTrack = (MyDecayChain->jet()->tracks().begin()); iTrack != MyDecayChain->jet()->tracks().end() ;++iTrack)
@@ -177,22 +175,22 @@ namespace vertex_lcfi
 		  }
 	      }
 
-	    TSHel = (**iTrack).makeState();  
+	    TrackState TSHel = (**iTrack).state();
 
 	    //this is a smart way of solving many problems
 	    // we swim near to the vertex since the cut is then perfomed at the vertex.
 	    //so if we have too many iterations we can cut the track
 
-	    TSLin->swimToStateNearest( MyDecayChain->vertices()[tempvertex]->position() );
+	    TSLin.swimToStateNearest( MyDecayChain->vertices()[tempvertex]->position() );
 
-       	    TSLin->swimToStateNearest( TSHel );
-	    TSHel->swimToStateNearest( TSLin );
+       	    TSLin.swimToStateNearest( &TSHel );
+	    TSHel.swimToStateNearest( &TSLin );
 
-	    closeapproach = ((*TSHel).position().subtract((*TSLin).position())).mag();
+	    closeapproach = (TSHel.position().subtract(TSLin.position())).mag();
 
-	    LoD = (TSLin->position().subtract((MyDecayChain->vertices()[0])->position())).mag();
+	    LoD = (TSLin.position().subtract((MyDecayChain->vertices()[0])->position())).mag();
 	    
-	    if( 0 > TSLin->position().subtract(MyDecayChain->vertices()[0]->position()).dot( VertexPos ) )
+	    if( 0 > TSLin.position().subtract(MyDecayChain->vertices()[0]->position()).dot( VertexPos ) )
 	    {
 	      LoD = LoD * (-1);
 	    }
@@ -46,6 +46,7 @@ namespace vertex_lcfi
 			paramNames.push_back("JetAxisX");
 			paramNames.push_back("JetAxisY");
 			paramNames.push_back("JetAxisZ");
+			paramNames.push_back("FitCache");
 			return paramNames;
 		}
 		
@@ -60,6 +61,7 @@ namespace vertex_lcfi
 			paramValues.push_back(makeString(_JetAxis.x()));
 			paramValues.push_back(makeString(_JetAxis.y()));
 			paramValues.push_back(makeString(_JetAxis.z()));
+			paramValues.push_back(makeString(_FitCache));
 			return paramValues;
 		}
 		
@@ -93,6 +95,20 @@ namespace vertex_lcfi
 				}
 				//TODO Throw Something
 			}
+			if (Parameter == "FitCache")
+			{
+				if (Value == "TRUE")
+				{
+					_FitCache = 1;
+					return;
+				}
+				if (Value == "FALSE")
+				{
+					_FitCache = 0;
+					return;
+				}
+				//TODO Throw Something
+			}
 			this->badParameter(Parameter);
 		}
 		
@@ -142,8 +158,7 @@ namespace vertex_lcfi
 			//Make the IP object for zvtop
 			if (_UseEventIP == 1)
 			{
-				IP = new InteractionPoint(MyJet->event()->interactionPoint(),MyJet->event()->interactionPointError());
-				MemoryManager<InteractionPoint>::Event()->registerObject(IP);
+				IP = MemoryManager<InteractionPoint>::Event()->make(MyJet->event()->interactionPoint(),MyJet->event()->interactionPointError());
 			}
 			else
 			{
@@ -159,8 +174,7 @@ namespace vertex_lcfi
 				ipcov(2,2)=0.002*0.002;
 				*/
 				//TODO Make these parameters of this class (not hard wired)
-				IP = new InteractionPoint(Vector3(0,0,0),ipcov);
-				MemoryManager<InteractionPoint>::Event()->registerObject(IP);
+				IP = MemoryManager<InteractionPoint>::Event()->make(Vector3(0,0,0),ipcov);
 			}
 			
 			//Make the jet axis parameter
@@ -188,6 +202,7 @@ namespace vertex_lcfi
 			VFinder.minimumProbability() = _MinimumProbability;
 			VFinder.initialGhostWidth() = _InitialGhostWidth;
 			VFinder.maxChi2Allowed() = _MaxChi2Allowed;
+			VFinder.useFitCache() = _FitCache;
 			std::list<CandidateVertex*> CVResult = VFinder.findVertices();
 			Track* GhostTrack = VFinder.lastGhost();
 			//Make Vertex objects from CandidateVertices
@@ -197,7 +212,7 @@ namespace vertex_lcfi
 				Vertex* MyVertex;
 				if (!(*iCV)->interactionPoint())
 				{
-					MyVertex = new Vertex(*iCV,MyJet->event());
+					MyVertex = MemoryManager<Vertex>::Event()->make(*iCV,MyJet->event());
 				}
 				else
 				{
@@ -208,17 +223,15 @@ namespace vertex_lcfi
 							Tracks.push_back((*iTrack)->parentTrack());
 						}
 						//TODO Fix chi2,prob value
-						MyVertex = new Vertex(MyJet->event(), Tracks, (*iCV)->interactionPoint()->position(), (*iCV)->interactionPoint()->errorMatrix(), (bool)(*iCV)->interactionPoint(),0,0);
+						MyVertex = MemoryManager<Vertex>::Event()->make(MyJet->event(), Tracks, (*iCV)->interactionPoint()->position(), (*iCV)->interactionPoint()->errorMatrix(), (bool)(*iCV)->interactionPoint(),0,0);
 				}
-				MemoryManager<Vertex>::Event()->registerObject(MyVertex);
 				//Remove the ghost!
 				MyVertex->removeTrack(GhostTrack);
 				VResult.push_back(MyVertex);
 			}
 			
 			//Make DecayChain from vertices
-			DecayChain* MyDecayChain = new DecayChain(MyJet, std::vector<Track*>(), VResult);
-			MemoryManager<DecayChain>::Event()->registerObject(MyDecayChain);
+			DecayChain* MyDecayChain = MemoryManager<DecayChain>::Event()->make(MyJet, std::vector<Track*>(), VResult);
 			return MyDecayChain;
 		}
 }
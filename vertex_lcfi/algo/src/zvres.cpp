@@ -16,6 +16,8 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <limits>
+#include <cmath>
 using std::string;
 
 
@@ -32,8 +34,18 @@ namespace vertex_lcfi
 			_TwoProngCut ( 10.0 ),
 			_TrackTrimCut ( 10.0 ),
 			_ResolverCut ( 0.6 ),
+			_TubeCullEpsilon ( 1e-12 ),
+			_CacheGridSize ( 0.0 ),
+			_ResolverSteps ( 10.0 ),
+			_ResolverRefinements ( 0.0 ),
+			_ResolverRadius ( 0.0 ),
+			_Threads ( 1.0 ),
 			_AutoJetAxis ( 1 ),
-			_UseEventIP ( 0 )
+			_UseEventIP ( 0 ),
+			_FitCache ( 1 ),
+			_VertexFunctionPrecision ( DoublePrecision ),
+			_MaxFinder ( ClassicStepperMaxFinder ),
+			_Resolver ( BisectionResolver )
 		{ }
 	
 		string ZVRES::name() const
@@ -54,6 +66,16 @@ namespace vertex_lcfi
 			paramNames.push_back("JetAxisY");
 			paramNames.push_back("JetAxisZ");
 			paramNames.push_back("UseEventIP");
+			paramNames.push_back("VertexFunctionPrecision");
+			paramNames.push_back("MaxFinder");
+			paramNames.push_back("TubeCullEpsilon");
+			paramNames.push_back("CacheGridSize");
+			paramNames.push_back("Resolver");
+			paramNames.push_back("ResolverSteps");
+			paramNames.push_back("ResolverRefinements");
+			paramNames.push_back("ResolverRadius");
+			paramNames.push_back("Threads");
+			paramNames.push_back("FitCache");
 			return paramNames;
 		}
 		
@@ -70,6 +92,29 @@ namespace vertex_lcfi
 			paramValues.push_back(makeString(_JetAxis.y()));
 			paramValues.push_back(makeString(_JetAxis.z()));
 			paramValues.push_back(makeString(_UseEventIP));
+			switch (_VertexFunctionPrecision)
+			{
+				case ValidatePrecision:
+					paramValues.push_back("VALIDATE");
+					break;
+				default:
+					paramValues.push_back("DOUBLE");
+			}
+			if (_MaxFinder == TrustRegionMaxFinder)
+				paramValues.push_back("TRUSTREGION");
+			else
+				paramValues.push_back("CLASSICSTEPPER");
+			paramValues.push_back(makeString(_TubeCullEpsilon));
+			paramValues.push_back(makeString(_CacheGridSize));
+			if (_Resolver == EqualStepsResolver)
+				paramValues.push_back("EQUALSTEPS");
+			else
+				paramValues.push_back("BISECTION");
+			paramValues.push_back(makeString(_ResolverSteps));
+			paramValues.push_back(makeString(_ResolverRefinements));
+			paramValues.push_back(makeString(_ResolverRadius));
+			paramValues.push_back(makeString(_Threads));
+			paramValues.push_back(makeString(_FitCache));
 			return paramValues;
 		}
 		
@@ -103,6 +148,62 @@ namespace vertex_lcfi
 				}
 				//TODO Throw Something
 			}
+			if (Parameter == "FitCache")
+			{
+				if (Value == "TRUE")
+				{
+					_FitCache = 1;
+					return;
+				}
+				if (Value == "FALSE")
+				{
+					_FitCache = 0;
+					return;
+				}
+				//TODO Throw Something
+			}
+			if (Parameter == "VertexFunctionPrecision")
+			{
+				if (Value == "DOUBLE")
+				{
+					_VertexFunctionPrecision = DoublePrecision;
+					return;
+				}
+				if (Value == "VALIDATE")
+				{
+					_VertexFunctionPrecision = ValidatePrecision;
+					return;
+				}
+				//TODO Throw Something
+			}
+			if (Parameter == "MaxFinder")
+			{
+				if (Value == "CLASSICSTEPPER")
+				{
+					_MaxFinder = ClassicStepperMaxFinder;
+					return;
+				}
+				if (Value == "TRUSTREGION")
+				{
+					_MaxFinder = TrustRegionMaxFinder;
+					return;
+				}
+				//TODO Throw Something
+			}
+			if (Parameter == "Resolver")
+			{
+				if (Value == "EQUALSTEPS")
+				{
+					_Resolver = EqualStepsResolver;
+					return;
+				}
+				if (Value == "BISECTION")
+				{
+					_Resolver = BisectionResolver;
+					return;
+				}
+				//TODO Throw Something
+			}
 			this->badParameter(Parameter);
 		}
 		
@@ -133,6 +234,39 @@ namespace vertex_lcfi
 				_ResolverCut = Value;
 				return;
 			}
+			if (Parameter == "TubeCullEpsilon")
+			{
+				_TubeCullEpsilon = Value;
+				return;
+			}
+			if (Parameter == "CacheGridSize")
+			{
+				_CacheGridSize = Value;
+				return;
+			}
+			if (Parameter == "ResolverSteps")
+			{
+				_ResolverSteps = Value;
+				return;
+			}
+			if (Parameter == "ResolverRefinements")
+			{
+				_ResolverRefinements = Value;
+				return;
+			}
+			if (Parameter == "ResolverRadius")
+			{
+				_ResolverRadius = Value;
+				return;
+			}
+			if (Parameter == "Threads")
+			{
+				//A whole number of threads, 0 for one per hardware thread
+				if (!(Value >= 0.0 && Value <= double(std::numeric_limits<unsigned int>::max())))
+					this->badParameter(Parameter);
+				_Threads = floor(Value + 0.5);
+				return;
+			}
 			if (Parameter == "JetAxisX")
 			{
 				_JetAxis.x() = Value;
@@ -162,8 +296,7 @@ namespace vertex_lcfi
 			//Make the IP object for zvtop
 			if (_UseEventIP == 1)
 			{
-				IP = new InteractionPoint(MyJet->event()->interactionPoint(),MyJet->event()->interactionPointError());
-				MemoryManager<InteractionPoint>::Event()->registerObject(IP);
+				IP = MemoryManager<InteractionPoint>::Event()->make(MyJet->event()->interactionPoint(),MyJet->event()->interactionPointError());
 			}
 			else
 			{
@@ -178,8 +311,7 @@ namespace vertex_lcfi
 				ipcov(2,2) = pow(20.0/1000.0,2);
 				
 				//TODO Make these parameters of this class (not hard wired)
-				IP = new InteractionPoint(Vector3(0,0,0),ipcov);
-				MemoryManager<InteractionPoint>::Event()->registerObject(IP);
+				IP = MemoryManager<InteractionPoint>::Event()->make(Vector3(0,0,0),ipcov);
 			}
 			
 			//Make the jet axis parameter
@@ -202,7 +334,11 @@ namespace vertex_lcfi
 			}
 			
 			//Run ZVTOP - result is in order of 3D distance from IP
-			VertexFinderClassic VFinder(MyJet->tracks(),IP,JetAxis,_Kip,_Kalpha,_TwoProngCut,_TrackTrimCut,_ResolverCut);
+			VertexFinderClassic VFinder(MyJet->tracks(),IP,JetAxis,_Kip,_Kalpha,_TwoProngCut,_TrackTrimCut,_ResolverCut,_VertexFunctionPrecision,_MaxFinder,_TubeCullEpsilon,_CacheGridSize);
+			VFinder.setResolver(_Resolver,int(_ResolverSteps),int(_ResolverRefinements));
+			VFinder.setResolverRadius(_ResolverRadius);
+			VFinder.setNumThreads((unsigned int)_Threads);
+			VFinder.setFitCache(_FitCache);
 			std::list<CandidateVertex*> CVResult = VFinder.findVertices();
 			
 			//Make Vertex objects from CandidateVertices
@@ -212,7 +348,7 @@ namespace vertex_lcfi
 				Vertex* MyVertex;
 				if (!(*iCV)->interactionPoint())
 				{
-					MyVertex = new Vertex(*iCV,MyJet->event());
+					MyVertex = MemoryManager<Vertex>::Event()->make(*iCV,MyJet->event());
 				}
 				else
 				{
@@ -223,15 +359,13 @@ namespace vertex_lcfi
 							Tracks.push_back((*iTrack)->parentTrack());
 						}
 						//TODO Fix chi2,prob value
-						MyVertex = new Vertex(MyJet->event(), Tracks, (*iCV)->interactionPoint()->position(), (*iCV)->interactionPoint()->errorMatrix(),(bool)(*iCV)->interactionPoint(),0,0);
+						MyVertex = MemoryManager<Vertex>::Event()->make(MyJet->event(), Tracks, (*iCV)->interactionPoint()->position(), (*iCV)->interactionPoint()->errorMatrix(),(bool)(*iCV)->interactionPoint(),0,0);
 				}
-				MemoryManager<Vertex>::Event()->registerObject(MyVertex);
 				VResult.push_back(MyVertex);
 			}
 			
 			//Make DecayChain from vertices
-			DecayChain* MyDecayChain = new DecayChain(MyJet, std::vector<Track*>(), VResult);
-			MemoryManager<DecayChain>::Event()->registerObject(MyDecayChain);
+			DecayChain* MyDecayChain = MemoryManager<DecayChain>::Event()->make(MyJet, std::vector<Track*>(), VResult);
 			return MyDecayChain;
 		}
 }
@@ -90,8 +90,8 @@ namespace vertex_lcfi
 			std::vector<std::string> Names = this->parameterNames();
 			for (std::vector<std::string>::const_iterator iP = Names.begin();iP != Names.end(); ++iP)
 				Msg << (*iP) << std::endl;
-			vertex_lcfi::MetaMemoryManager::Run()->delAllObjects();
-			vertex_lcfi::MetaMemoryManager::Event()->delAllObjects();
+			vertex_lcfi::MetaMemoryManager::Run()->delAllObjects(this->name());
+			vertex_lcfi::MetaMemoryManager::Event()->delAllObjects(this->name());
 			//Replace with your systems exception if not LCIO
 			throw lcio::Exception(Msg.str());
 		}
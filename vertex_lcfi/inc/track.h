@@ -54,6 +54,13 @@ namespace vertex_lcfi
 		*/
 		TrackState* makeState() const;
 		
+		//! Make a TrackState of this track by value
+		/*!
+		No memory is allocated, use this for temporary swims that don't need to outlive the caller.
+		\return A trackstate of this track at the reference point
+		*/
+		TrackState state() const;
+		
 		//! Helix represenation of this track
 		/*!
 		\return The helix representation of this track
@@ -0,0 +1,146 @@
+#ifndef LCFITRACKBATCH_H
+#define LCFITRACKBATCH_H
+
+#include "../util/inc/matrix.h"
+#include "../util/inc/vector3.h"
+#include "../util/inc/helixrep.h"
+#include <vector>
+#include <cstddef>
+
+namespace vertex_lcfi
+{
+	using namespace vertex_lcfi::util;
+
+	//Forward Declarations
+	class Track;
+	class Jet;
+	class Event;
+
+	//!Structure of arrays copy of the parameters of a set of tracks
+	/*!
+	Built once from a jet (or any list of tracks) so that loops over the tracks
+	read contiguous arrays instead of following a pointer to each Track.
+	Each helix parameter, the charge, each momentum component and each of the
+	15 packed covariance elements is held in its own array indexed by track
+	number, arrays are padded to a multiple of 4 entries. Track i of the batch
+	is tracks()[i], so the full Track interface remains available by index.
+	The batch is a snapshot, changes to the tracks after filling are not seen.
+	*/
+	class TrackBatch
+	{
+		public:
+
+		//! Default Constructor, an empty batch
+		TrackBatch();
+
+		//! Construct from the tracks of a jet
+		/*!
+		\param MyJet Jet to take the tracks from
+		*/
+		explicit TrackBatch(const Jet* MyJet);
+
+		//! Construct from a list of tracks, all from the same event
+		/*!
+		\param Tracks Tracks to copy, in the order they will be indexed
+		*/
+		explicit TrackBatch(const std::vector<Track*> & Tracks);
+
+		//! Refill the batch from a list of tracks, reusing the storage
+		/*!
+		\param Tracks Tracks to copy, in the order they will be indexed
+		*/
+		void fill(const std::vector<Track*> & Tracks);
+
+		//! Number of tracks in the batch
+		inline std::size_t size() const
+		{return _Tracks.size();}
+
+		//! Length of each array including padding
+		inline std::size_t stride() const
+		{return _Stride;}
+
+		//! Track with index i
+		inline Track* track(std::size_t i) const
+		{return _Tracks[i];}
+
+		//! Tracks in index order
+		inline const std::vector<Track*> & tracks() const
+		{return _Tracks;}
+
+		//! Index of a track in the batch, or size() if not present
+		std::size_t indexOf(const Track* MyTrack) const;
+
+		//! Event the tracks belong to, 0 for an empty batch
+		inline Event* event() const
+		{return _Event;}
+
+		//! Helix parameter arrays
+		inline const double* d0() const {return _D0.data();}
+		inline const double* z0() const {return _Z0.data();}
+		inline const double* phi() const {return _Phi.data();}
+		inline const double* invR() const {return _InvR.data();}
+		inline const double* tanLambda() const {return _TanLambda.data();}
+
+		//! Charge array
+		inline const double* charge() const {return _Charge.data();}
+
+		//! Perigee momentum component arrays
+		inline const double* px() const {return _Px.data();}
+		inline const double* py() const {return _Py.data();}
+		inline const double* pz() const {return _Pz.data();}
+
+		//! Array of one element of the track covariance matrices
+		/*!
+		\param Row Row of the element, 0 to 4 in the helix parameter order of SymMatrix5x5
+		\param Col Column of the element
+		\return Pointer to the element for track 0, track i follows at offset i
+		*/
+		inline const double* covariance(std::size_t Row, std::size_t Col) const
+		{return _Covariance.data()+_packedIndex(Row,Col)*_Stride;}
+
+		//! Unsigned RPhi and Z impact parameter significances of all tracks
+		/*!
+		Gives the same values as Track::significance(RPhi) and Track::significance(Z),
+		swimming each track only once for both projections.
+		\param RPhi Output array of at least size() entries
+		\param Z Output array of at least size() entries
+		*/
+		void significances(double* RPhi, double* Z) const;
+
+		//! Signed RPhi and Z impact parameter significances of all tracks
+		/*!
+		Gives the same values as Track::signedSignificance(RPhi,Jet) and
+		Track::signedSignificance(Z,Jet) for a jet with momentum JetMomentum.
+		\param JetMomentum Momentum of the jet to sign the significances with
+		\param RPhi Output array of at least size() entries
+		\param Z Output array of at least size() entries
+		*/
+		void signedSignificances(const Vector3 & JetMomentum, double* RPhi, double* Z) const;
+
+		private:
+		static inline std::size_t _packedIndex(std::size_t Row, std::size_t Col)
+		{return (Row >= Col) ? Row*(Row+1)/2+Col : Col*(Col+1)/2+Row;}
+
+		//XY point of closest approach to the IP relative to the IP, as TrackState::swimToStateNearestXY
+		void _pocaToIP(double* X, double* Y, double* Z) const;
+		void _significances(const Vector3* JetMomentum, double* RPhi, double* Z) const;
+
+		std::vector<Track*>	_Tracks;
+		Event*			_Event;
+		std::size_t		_Stride;
+		std::vector<double>	_D0;
+		std::vector<double>	_Z0;
+		std::vector<double>	_Phi;
+		std::vector<double>	_InvR;
+		std::vector<double>	_TanLambda;
+		std::vector<double>	_Charge;
+		std::vector<double>	_Px;
+		std::vector<double>	_Py;
+		std::vector<double>	_Pz;
+		//Whole helices for the XY swim, with their derived constants worked out once
+		std::vector<HelixRep>	_Helices;
+		std::vector<double>	_Covariance;
+	};
+}
+
+#endif //LCFITRACKBATCH_H
@@ -6,6 +6,7 @@
 #include "../util/inc/helixrep.h"
 #include "../inc/track.h"
 #include <ostream>
+#include <cstddef>
 
 namespace vertex_lcfi
 {
@@ -50,7 +51,12 @@ For details of the parameterisation see Track
 		void swimDistance(const double s);
 		
 		//!Swim to the point of closest approach to Point
-		void swimToStateNearest(const Vector3 & Point);
+		/*!
+		Starts from the XY point of closest approach and refines along the helix with
+		Halley steps on the derivative of the squared distance.
+		\return false if the step had not fallen below the swim precision after the maximum number of iterations
+		*/
+		bool swimToStateNearest(const Vector3 & Point);
 		
 		//!Swim to the point of closest approach to another TrackState
 		void swimToStateNearest(TrackState* const TrackToSwimTo);
@@ -83,6 +89,17 @@ For details of the parameterisation see Track
 		//!Calculate this tracks minimum chi squared to Point
 		double chi2(const Vector3 &Point);
 		
+		//!Calculate this tracks minimum chi squared to each of a series of nearby points
+		/*!
+		Each swim after the first starts from the solution for the previous point, so
+		closely spaced points (as in numerical derivatives) need only a step or two each.
+		Agrees with chi2(Point) to within the swim precision.
+		\param Points Array of NumPoints points, best ordered so neighbours are close
+		\param NumPoints Number of points
+		\param Chi2 Output array of NumPoints chi squareds
+		*/
+		void chi2(const Vector3* Points, std::size_t NumPoints, double* Chi2);
+		
 		//!Calculate this tracks chi squared to Point at the TrackStates current position
 		double chi2_nomove(const Vector3 &Point);
 		
@@ -91,6 +108,9 @@ For details of the parameterisation see Track
 		//!Current position of the trackstate
 		const Vector3 &		position() const;
 		
+		//!Direction of travel at the current position, the derivative of position() with distance swum
+		Vector3			direction() const;
+		
 		//!Current phi of the trackstate
 		inline double phi() const
 		{return std::fmod(_Init.phi()+(_DistanceSwum*(_Init.invR())), 2.0*3.141592654);}
@@ -126,6 +146,14 @@ For details of the parameterisation see Track
 		inline Track*			parentTrack() const
 		{return _ParentTrack;}
 
+		//!Index of the parent track in the table of tracks being vertexed, -1 if not set
+		inline int		tableIndex() const
+		{return _TableIndex;}
+
+		//!Set the index of the parent track in the table of tracks being vertexed
+		inline void		setTableIndex(int Index)
+		{_TableIndex = Index;}
+
 		//!Print some info to std::cout
 		void			debugOut();
 		
@@ -143,6 +171,9 @@ For details of the parameterisation see Track
 		
 		mutable Vector3		_Position{};
 		mutable bool		_PosValid{};
+		//Direction of the track in XY at _Position, sin and cos of phi-invR*s, charged tracks only
+		mutable double		_SinPsi=0.0;
+		mutable double		_CosPsi=1.0;
 		
 		mutable Vector3		_Momentum{};
 		mutable bool		_MomValid{};
@@ -163,9 +194,19 @@ For details of the parameterisation see Track
 		
 		//Pointer to Track that created this state
 		Track*			_ParentTrack=nullptr;
+		//Index of the parent track in the caller's table of tracks
+		int			_TableIndex=-1;
+		
+		//Halley steps to the 3D point of closest approach from the current position, false if not converged
+		bool			_swimToNearestFromHere(const Vector3 & Point);
+		//Newton steps to the XY point of closest approach from the current position, false if not converged
+		bool			_swimToNearestXYFromHere(const Vector3 & Point);
+		//chi2 at the current position, which should be the 3D point of closest approach
+		double			_chi2AtNearest(const Vector3 & Point, double XYDistance);
 
 		//Swimmer to use if none specified
 		static const double 	_swimprecision; //Set in CPP file
+		static const int	_maxSwimIterations; //Set in CPP file
 	};
 
 	template <class charT, class traits> inline
@@ -13,14 +13,12 @@ namespace vertex_lcfi
 		IPError(0,0) = 10.0/1000.0;	
 		IPError(1,1) = 10.0/1000.0;
 		IPError(2,2) = 10.0/1000.0;
-		_IPVertex = new Vertex((this), std::vector<Track*>(), Vector3(0,0,0), IPError, true, 0, 1);
-		MemoryManager<Vertex>::Event()->registerObject(_IPVertex);
+		_IPVertex = MemoryManager<Vertex>::Event()->make((this), std::vector<Track*>(), Vector3(0,0,0), IPError, true, 0, 1);
 	}
 	
 	Event::Event(const Vector3 & Position, const SymMatrix3x3 & Error)
 	{
-		_IPVertex = new Vertex(const_cast<Event*>(this), std::vector<Track*>(), Position, Error, true, 0, 1);
-		MemoryManager<Vertex>::Event()->registerObject(_IPVertex);
+		_IPVertex = MemoryManager<Vertex>::Event()->make(const_cast<Event*>(this), std::vector<Track*>(), Position, Error, true, 0, 1);
 	}
 	
 	Event::Event(Vertex* ipVertex)
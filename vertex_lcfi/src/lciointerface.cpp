@@ -199,8 +199,7 @@ vertex_lcfi::Vertex* vertexFromLCIOVertex(lcio::Vertex* LCIOVertex, Event* MyEve
 	PosErr(2,1)=LCIOVertex->getCovMatrix()[4];
 	PosErr(2,2)=LCIOVertex->getCovMatrix()[5];
 	
-	vertex_lcfi::Vertex* LCFIVertex = new vertex_lcfi::Vertex(MyEvent, vector<Track*>(), Pos, PosErr, LCIOVertex->isPrimary(), LCIOVertex->getChi2(), LCIOVertex->getProbability());
-	MemoryManager<vertex_lcfi::Vertex>::Event()->registerObject(LCFIVertex);
+	vertex_lcfi::Vertex* LCFIVertex = MemoryManager<vertex_lcfi::Vertex>::Event()->make(MyEvent, vector<Track*>(), Pos, PosErr, LCIOVertex->isPrimary(), LCIOVertex->getChi2(), LCIOVertex->getProbability());
 	
 	return LCFIVertex;
 }	
@@ -237,8 +236,7 @@ DecayChain* decayChainFromLCIORP(Jet* LCFIJet, ReconstructedParticle* DecayChain
 		 }
 	}
 
-	DecayChain* NewDecayChain = new DecayChain(LCFIJet,vector<Track*>(),vector<vertex_lcfi::Vertex*>());
-	MemoryManager<vertex_lcfi::DecayChain>::Event()->registerObject(NewDecayChain);
+	DecayChain* NewDecayChain = MemoryManager<vertex_lcfi::DecayChain>::Event()->make(LCFIJet,vector<Track*>(),vector<vertex_lcfi::Vertex*>());
 	
 	vector<vertex_lcfi::Vertex*> LCFIVertices;
 	map<lcio::Vertex*,vertex_lcfi::Vertex*> LCFIVertex;
@@ -17,6 +17,8 @@ namespace vertex_lcfi
 	Track::Track(Event* Event, const HelixRep & H,const Vector3 & Momentum,const double & cha, const SymMatrix5x5 & cov, std::vector<int> hits, void* trackNum)
 	: _Event(Event),_H(H),_PMomentum(Momentum),_Charge(cha),_CovarianceMatrix(cov),_NumHitsSubDetector(hits),_TrackingNum(trackNum)
 	{
+		//Fill the cached helix constants now, so the TrackStates copying them don't each recalculate
+		_H.theta();
 	}
 
 	Event* Track::event() const
@@ -26,9 +28,12 @@ namespace vertex_lcfi
 	
 	TrackState* Track::makeState() const
 	{
-		TrackState* ts = new TrackState(_H,_Charge,_CovarianceMatrix, (Track*)this); 
-		MemoryManager<TrackState>::Event()->registerObject(ts);
-		return ts;
+		return MemoryManager<TrackState>::Event()->make(_H,_Charge,_CovarianceMatrix, (Track*)this);
+	}
+	
+	TrackState Track::state() const
+	{
+		return TrackState(_H,_Charge,_CovarianceMatrix, (Track*)this);
 	}
 	//Make TrackState at reference point with specified swimmer
 	
@@ -61,15 +66,15 @@ namespace vertex_lcfi
 		//define some nice index numbers
 		short x=0;short y=1;//short z=2;
 		//Swim a trackstate to the point of closest approach to the events IP
-		TrackState* track = this->makeState();
+		TrackState track = this->state();
 		const SymMatrix3x3 & IPErr =this->event()->interactionPointError();
 		//TODO Cope with case where track is used in IP fit?
 		switch (Proj)
 		{
 		case RPhi:
 		  {
-		    track->swimToStateNearestXY(this->event()->interactionPoint());
-		    Vector3 POCAVector = track->position() - this->event()->interactionPoint();
+		    track.swimToStateNearestXY(this->event()->interactionPoint());
+		    Vector3 POCAVector = track.position() - this->event()->interactionPoint();
 		    double ErrorIP = (IPErr(x,x)*pow(POCAVector.x(),2.0) + 2.0*IPErr(x,y)*POCAVector.x()*POCAVector.y() + IPErr(y,y)*pow(POCAVector.y(),2.0)) / POCAVector.mag2(RPhi); 
 		    double ErrorTrack = this->covarianceMatrix()(0,0);
 		    if (ErrorIP <= 0.0)
@@ -82,8 +87,8 @@ namespace vertex_lcfi
 		  }
 		case Z:
 		  {
-		    track->swimToStateNearestXY(this->event()->interactionPoint());
-		    Vector3 POCAVector = track->position() - this->event()->interactionPoint();
+		    track.swimToStateNearestXY(this->event()->interactionPoint());
+		    Vector3 POCAVector = track.position() - this->event()->interactionPoint();
 		    double ErrorIP = determinant(IPErr)/(IPErr(x,x)*IPErr(y,y)-IPErr(x,y)*IPErr(x,y));//IPErr(z,z);
 		    double ErrorTrack = this->covarianceMatrix()(3,3);
  		    if (ErrorIP <= 0.0)
@@ -95,9 +100,9 @@ namespace vertex_lcfi
 		  }
 		case ThreeD:
 		  {
-		    track->swimToStateNearest(this->event()->interactionPoint());
-		    Vector3 POCAVector = track->position() - this->event()->interactionPoint();
-		    double ErrorIP = prec_inner_prod(prec_prod(IPErr,POCAVector),POCAVector);
+		    track.swimToStateNearest(this->event()->interactionPoint());
+		    Vector3 POCAVector = track.position() - this->event()->interactionPoint();
+		    double ErrorIP = quadraticForm(IPErr,POCAVector);
 		    //double ErrorIP = (IPErr(x,x)*pow(POCAVector.x(),2.0) + 2*IPErr(x,y)*POCAVector.x()*POCAVector.y() + IPErr(y,y)*pow(POCAVector.y(),2.0)  + IPErr(z,z)*pow(POCAVector.z(),2.0)+ 2*IPErr(x,z)*POCAVector.x()*POCAVector.z() +2*IPErr(z,y)*POCAVector.z()*POCAVector.y())/ POCAVector.mag2(ThreeD) ; 
 		    //this should probably be only 0,0+3,3 given the definition of the POCAVector in the Rphi case.
 		    //ignore cross terms? 
@@ -119,9 +124,9 @@ namespace vertex_lcfi
   double Track::signedSignificance(Projection Proj, Jet *MyJet) const
   {
 
-    TrackState* track = this->makeState();
-    track->swimToStateNearestXY(this->event()->interactionPoint());
-    Vector3 POCAVector = track->position() - this->event()->interactionPoint();    
+    TrackState track = this->state();
+    track.swimToStateNearestXY(this->event()->interactionPoint());
+    Vector3 POCAVector = track.position() - this->event()->interactionPoint();    
     switch (Proj)
       {
 		case RPhi:
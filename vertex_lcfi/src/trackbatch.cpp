@@ -0,0 +1,160 @@
+#include "../inc/trackbatch.h"
+#include "../inc/track.h"
+#include "../inc/trackstate.h"
+#include "../inc/event.h"
+#include "../inc/jet.h"
+#include "../util/inc/helixrep.h"
+#include <cmath>
+#include <iostream>
+
+namespace vertex_lcfi
+{
+	using namespace vertex_lcfi::util;
+
+	TrackBatch::TrackBatch()
+	: _Event(0),_Stride(0)
+	{}
+
+	TrackBatch::TrackBatch(const Jet* MyJet)
+	: _Event(0),_Stride(0)
+	{
+		this->fill(MyJet->tracks());
+	}
+
+	TrackBatch::TrackBatch(const std::vector<Track*> & Tracks)
+	: _Event(0),_Stride(0)
+	{
+		this->fill(Tracks);
+	}
+
+	void TrackBatch::fill(const std::vector<Track*> & Tracks)
+	{
+		_Tracks = Tracks;
+		_Event = Tracks.empty() ? 0 : Tracks.front()->event();
+		//Pad so that every array holds whole groups of 4 doubles
+		_Stride = (Tracks.size()+3) & ~std::size_t(3);
+
+		_D0.assign(_Stride,0.0);
+		_Z0.assign(_Stride,0.0);
+		_Phi.assign(_Stride,0.0);
+		_InvR.assign(_Stride,0.0);
+		_TanLambda.assign(_Stride,0.0);
+		_Charge.assign(_Stride,0.0);
+		_Px.assign(_Stride,0.0);
+		_Py.assign(_Stride,0.0);
+		_Pz.assign(_Stride,0.0);
+		_Helices.assign(Tracks.size(),HelixRep());
+		_Covariance.assign(15*_Stride,0.0);
+
+		for (std::size_t i = 0; i < Tracks.size(); ++i)
+		{
+			const Track* MyTrack = Tracks[i];
+			const HelixRep & H = MyTrack->helixRep();
+			_D0[i] = H.d0();
+			_Z0[i] = H.z0();
+			_Phi[i] = H.phi();
+			_InvR[i] = H.invR();
+			_TanLambda[i] = H.tanLambda();
+			_Helices[i] = H;
+			_Charge[i] = MyTrack->charge();
+			_Px[i] = MyTrack->momentum().x();
+			_Py[i] = MyTrack->momentum().y();
+			_Pz[i] = MyTrack->momentum().z();
+			const SymMatrix5x5 & Cov = MyTrack->covarianceMatrix();
+			for (std::size_t Row = 0; Row < 5; ++Row)
+				for (std::size_t Col = 0; Col <= Row; ++Col)
+					_Covariance[_packedIndex(Row,Col)*_Stride+i] = Cov(Row,Col);
+		}
+	}
+
+	std::size_t TrackBatch::indexOf(const Track* MyTrack) const
+	{
+		for (std::size_t i = 0; i < _Tracks.size(); ++i)
+			if (_Tracks[i] == MyTrack)
+				return i;
+		return _Tracks.size();
+	}
+
+	void TrackBatch::_pocaToIP(double* X, double* Y, double* Z) const
+	{
+		const Vector3 & IP = _Event->interactionPoint();
+		for (std::size_t i = 0; i < _Tracks.size(); ++i)
+		{
+			//Neutrals are rare, leave them to TrackState
+			if (fabs(_Charge[i])<0.000001)
+			{
+				TrackState State = _Tracks[i]->state();
+				State.swimToStateNearestXY(IP);
+				X[i] = State.position().x() - IP.x();
+				Y[i] = State.position().y() - IP.y();
+				Z[i] = State.position().z() - IP.z();
+				continue;
+			}
+
+			//The swim of TrackState::swimToStateNearestXY, from a copy of the helix
+			double x,y,z,SinPsi,CosPsi;
+			_Helices[i].positionAt(_Helices[i].xyPocaDistance(IP.x(),IP.y(),IP.z(),0.0001),x,y,z,SinPsi,CosPsi);
+			X[i] = x - IP.x();
+			Y[i] = y - IP.y();
+			Z[i] = z - IP.z();
+		}
+	}
+
+	void TrackBatch::_significances(const Vector3* JetMomentum, double* RPhi, double* Z) const
+	{
+		if (_Tracks.empty())
+			return;
+
+		std::vector<double> X(_Stride),Y(_Stride),DZ(_Stride);
+		this->_pocaToIP(&X[0],&Y[0],&DZ[0]);
+
+		const SymMatrix3x3 & IPErr = _Event->interactionPointError();
+		const double IPxx = IPErr(0,0);
+		const double IPxy = IPErr(0,1);
+		const double IPyy = IPErr(1,1);
+		const double ErrorIPZ = determinant(IPErr)/(IPxx*IPyy-IPxy*IPxy);
+		const double* ErrorTrackRPhi = this->covariance(0,0);
+		const double* ErrorTrackZ = this->covariance(3,3);
+
+		double TanlambdaJet = 0;
+		if (JetMomentum)
+			TanlambdaJet = JetMomentum->z()/sqrt(pow(JetMomentum->x(),2.0)+pow(JetMomentum->y(),2.0));
+
+		for (std::size_t i = 0; i < _Tracks.size(); ++i)
+		{
+			const double x = X[i];
+			const double y = Y[i];
+			const double ErrorIP = (IPxx*pow(x,2.0) + 2.0*IPxy*x*y + IPyy*pow(y,2.0)) / (pow(x,2) + pow(y,2));
+			if (ErrorIP <= 0.0)
+				std::cerr << "-ve IP Error of " << ErrorIP << ": TrackBatch::significances" << std::endl;
+			if (ErrorTrackRPhi[i] <= 0.0)
+				std::cerr << "-ve Track Error of " << ErrorTrackRPhi[i] << ": TrackBatch::significances" << std::endl;
+			if (ErrorIPZ <= 0.0)
+				std::cerr << "-ve IP Error of " << ErrorIPZ << ": TrackBatch::significances" << std::endl;
+			if (ErrorTrackZ[i] <= 0.0)
+				std::cerr << "-ve Track Error of " << ErrorTrackZ[i] << ": TrackBatch::significances" << std::endl;
+
+			RPhi[i] = std::sqrt(pow(x,2) + pow(y,2))/sqrt(ErrorIP+ErrorTrackRPhi[i]);
+			Z[i] = fabs(DZ[i])/sqrt(ErrorIPZ+ErrorTrackZ[i]);
+
+			if (JetMomentum)
+			{
+				//Positive if the track and jet cross in front of the IP, as Track::signedSignificance
+				if (((x*JetMomentum->x())+(y*JetMomentum->y())) < 0)
+					RPhi[i] = -RPhi[i];
+				if (DZ[i]*(TanlambdaJet - _TanLambda[i]) < 0)
+					Z[i] = -Z[i];
+			}
+		}
+	}
+
+	void TrackBatch::significances(double* RPhi, double* Z) const
+	{
+		this->_significances(0,RPhi,Z);
+	}
+
+	void TrackBatch::signedSignificances(const Vector3 & JetMomentum, double* RPhi, double* Z) const
+	{
+		this->_significances(&JetMomentum,RPhi,Z);
+	}
+}
@@ -13,6 +13,7 @@ namespace vertex_lcfi
 {
 
 	const double TrackState::_swimprecision = 0.0001; //.1 Micron
+	const int TrackState::_maxSwimIterations = 8;
 
 	TrackState::TrackState(Track* TTrack)
 	{
@@ -43,7 +44,7 @@ namespace vertex_lcfi
 		_PositionCovarValid = 0;
 	}
 
-	void TrackState::swimToStateNearest(const Vector3 & Point)
+	bool TrackState::swimToStateNearest(const Vector3 & Point)
 	{
 	if (this->isNeutral())
 		{
@@ -64,111 +65,89 @@ namespace vertex_lcfi
 			//Use XY Nearest as starting point
 			this->swimToStateNearestXY(Point);
 			//Check we're not sitting on the point
-			if (this->distanceTo(Point)<_swimprecision) return;
+			if (this->distanceTo(Point)<_swimprecision) return true;
+			return this->_swimToNearestFromHere(Point);
+		}
+		//TODO Iterative fallback for non helical?
+		return true;
+		}
+	
+	bool TrackState::_swimToNearestFromHere(const Vector3 & Point)
+	{
+		//Halley iteration for the root of g(s) = r.dr/ds, half the derivative of the
+		//squared distance r = position(s)-Point, with the helix derivatives in closed form:
+		//  dr/ds = (cos psi, sin psi, tanL), d2r/ds2 = k(sin psi, -cos psi, 0), d3r/ds3 = -k.k(cos psi, sin psi, 0)
+		//where psi = phi - k.s and k = invR. As |dr/ds| is constant g'(s) = 1 + tanL^2 + r.d2r/ds2.
+		const double k = _Init.invR();
+		const double tanL = _Init.tanLambda();
+		const double speed = _Init.secLambda();
+		//Never step more than a radian round the circle so we stay in the starting minimum
+		const double maxStep = fabs(_Init.radius());
+		
+		for (int iteration = 0; iteration < _maxSwimIterations; ++iteration)
+		{
+			//position() also gives the direction psi
+			const Vector3 & Pos = this->position();
+			const double sinPsi = _SinPsi;
+			const double cosPsi = _CosPsi;
+			const double rx = Pos.x() - Point.x();
+			const double ry = Pos.y() - Point.y();
+			const double rz = Pos.z() - Point.z();
 			
-			bool done;
-			short loopcount =0;
-			do
-			{
-				double s0 = _DistanceSwum;
-				Vector3 P = Point;
-				Vector3 initPos = this->position();
-				//Shift frame to the origin in xy plane
-				//Taylor expansion of d(Distancetopoint)/ds - finding roots finds minima and maxima
-				double invrval = -_Init.invR();
-				double c = (-2*(-(invrval*_Init.tanLambda()*(_Init.z0() - P.z() + s0*_Init.tanLambda())) + invrval*P.x()*cos(_Init.phi() + invrval*s0) + (-1.0 + invrval*-_Init.d0())*sin(invrval*s0) + invrval*P.y()*sin(_Init.phi() + invrval*s0)))/invrval;
-				double b = 2*(pow(_Init.tanLambda(),2) + (1.0 - invrval*-_Init.d0())*cos(invrval*s0) - invrval*P.y()*cos(_Init.phi() + invrval*s0) + invrval*P.x()*sin(_Init.phi() + invrval*s0));
-				double a = invrval*(invrval*P.x()*cos(_Init.phi() + invrval*s0) + (-1.0 + invrval*-_Init.d0())*sin(invrval*s0) + invrval*P.y()*sin(_Init.phi() + invrval*s0));
+			const double g = rx*cosPsi + ry*sinPsi + rz*tanL;
+			const double dg = speed*speed + k*(rx*sinPsi - ry*cosPsi);
+			const double ddg = -k*k*(rx*cosPsi + ry*sinPsi);
 			
-				//Get two solutions for s:
-				double s1,s2;
-				//Check a != 0
-				if (fabs(a)>std::numeric_limits<double>::epsilon())
-				{
-					double root = sqrt((b*b)-(4*a*c));
-					s1 = (-b + root)/(2*a);
-					s2 = (-b - root)/(2*a);
-				}
-				else
-				{
-					s1 = -c/b;
-					s2 = -c/b;
-				}					
-				//std::cout << "s12: " << s1 <<" " <<s2<<std::endl; 
-				double s1ToPoint,s2ToPoint;
-				//Swim to s1
-#ifdef WIN32
-				if (_finite(s1) && fabs(s1) < 10000)
-#else
-				if (std::isfinite(s1) && fabs(s1) < 10000)
-#endif
-				{
-					this->swimDistance(s1);
-					s1ToPoint = this->distanceTo2(Point);
-					this->swimDistance(-s1);
-				}
-				else
-				{
-#ifdef WIN32	//this template version could probably be used for both, but need to check first
-					s1ToPoint = std::numeric_limits<double>::infinity();
-#else
-					s1ToPoint = INFINITY;
-#endif
-				}
-				
-#ifdef WIN32
-				if (_finite(s2) && fabs(s2) < 10000)
-#else
-				if (std::isfinite(s2) && fabs(s2) < 10000)
-#endif
-				{
-					this->swimDistance(s2);
-					s2ToPoint = this->distanceTo2(Point);
-					this->swimDistance(-s2);
-				}
-				else
-				{
-#ifdef WIN32	//this template version could probably be used for both, but need to check first
-					s2ToPoint = std::numeric_limits<double>::infinity();
-#else
-					s2ToPoint = INFINITY;
-#endif
-				}
-				
-				if (std::isfinite(s1ToPoint) && std::isfinite(s2ToPoint))
-				{
-					if (s1ToPoint < s2ToPoint)
-						this->swimDistance(s1);
-					else
-						this->swimDistance(s2);
-				}
-				else
-				{
-					if (std::isfinite(s1ToPoint))
-						this->swimDistance(s1);
-					else
-					{
-						if (std::isfinite(s2ToPoint))
-							this->swimDistance(s1);
-						else
-							//Both Infinite give up
-							done = true;
-					}
-				}
-							
-				//If we moved a shorter distance than the precison so stop
-				done = (this->distanceTo(initPos) < _swimprecision);
-				
-				++loopcount;
-			} while (!done && loopcount < 100);
-			if (loopcount == 100) 
+			double step;
+			if (dg > 0)
+			{
+				step = -g/dg;
+				//Halley correction, only when it is a small change to the Newton step
+				const double correction = 1.0 - 0.5*g*ddg/(dg*dg);
+				if (correction > 0.5 && correction < 2.0)
+					step /= correction;
+			}
+			else
 			{
-				std::cerr << "Warning: TrackState.cpp:167:swimToStateNearest Max Iterations reached" << std::endl;
-				std::cerr << "Point " << Point << " Track:" << *this << std::endl;
-			}  
+				//Near a maximum of the distance, move downhill
+				step = (g > 0) ? -maxStep : maxStep;
+			}
+			if (step > maxStep) step = maxStep;
+			if (step < -maxStep) step = -maxStep;
+			
+			this->swimDistance(step);
+			
+			//If we moved a shorter distance than the precison so stop
+			if (fabs(step)*speed < _swimprecision)
+				return true;
 		}
-		//TODO Iterative fallback for non helical?
+		return false;
+	}
+	
+	bool TrackState::_swimToNearestXYFromHere(const Vector3 & Point)
+	{
+		//Newton iteration for the root of r.dr/ds in XY, as in _swimToNearestFromHere but with no z term
+		const double k = _Init.invR();
+		const double maxStep = fabs(_Init.radius());
+		for (int iteration = 0; iteration < _maxSwimIterations; ++iteration)
+		{
+			const Vector3 & Pos = this->position();
+			const double rx = Pos.x() - Point.x();
+			const double ry = Pos.y() - Point.y();
+			const double g = rx*_CosPsi + ry*_SinPsi;
+			const double dg = 1.0 + k*(rx*_SinPsi - ry*_CosPsi);
+			//Not near a minimum, leave it to the analytic solution
+			if (dg <= 0)
+				return false;
+			const double step = -g/dg;
+			if (fabs(step) > maxStep)
+				return false;
+			this->swimDistance(step);
+			if (fabs(step) < _swimprecision)
+				return true;
 		}
+		return false;
+	}
 		
 
 	void TrackState::swimToStateNearest(TrackState* const TrackToSwimTo)
@@ -301,41 +280,9 @@ namespace vertex_lcfi
 	
 		if (this->isCharged())
 		{
-			//std::cout << "XY POCA" << std::endl;
 			this->resetToRef();
-			if (this->xyDistanceTo(Point)<_swimprecision) return;
-				
-			//So first find center of the circle in the XY plane
-			Vector3 center = Vector3(this->position().x()+ (sin(_Init.phi())/_Init.invR()) , this->position().y()- (cos(_Init.phi())/_Init.invR()),0);
-			
-			//Get the points vector from this circle center
-			Vector3 P2 = Point - center;
-			
-			//d distance to point on circle / ds solved for zero points gives:
-			double distanceRoundCircle = atan(P2.x()/P2.y())/_Init.invR();
-			
-			//This distance is relative to the top of the circle, wheras our refpoint is phi dependant
-			distanceRoundCircle = distanceRoundCircle + (_Init.phi()/_Init.invR());
-			
-			//Thats one of two possible minima, check which one we want, we reset earlier so we're swimming relative to the refpoint
-			this->swimDistance(distanceRoundCircle);
-			double dist1 = this->xyDistanceTo(Point);
-			
-			//Swim to the second point 180 degrees away
-			//where we started
-			this->swimDistance(_Init.halfCircum());
-			double dist2 = this->xyDistanceTo(Point);
-			
-			//If the first one was the best swim back to it.
-			if (dist1 < dist2) this->swimDistance(-_Init.halfCircum());
-			
-			//Some procedures use a z measurement from the XY POCA
-			//So we should be in the helix cycle nearest in z
-			//Work out how many cycles away we are and swim back the opposite
-			this->swimDistance(-_Init.circum() * round(this->position().subtract(Point).z() / _Init.zLength()));
-			
-			//std::cout << "Done - XY POCA" << std::endl;
-			//We're done
+			//The nearer of the two points level with Point round the circle, in the helix cycle nearest in z
+			this->swimDistance(_Init.xyPocaDistance(Point.x(),Point.y(),Point.z(),_swimprecision));
 		} 
 	}
 	
@@ -344,9 +291,69 @@ namespace vertex_lcfi
 		boost::numeric::ublas::bounded_vector<double,2> Residual;
 		//XY Dist in 2D
 		this->swimToStateNearestXY(Point);
-		Residual(0) = this->xyDistanceTo(Point);
-		//Z in 3D
-		this->swimToStateNearest(Point);
+		const double XYDistance = this->xyDistanceTo(Point);
+		//Z in 3D, swimToStateNearest would start by repeating the XY swim so carry on from here
+		if (this->isCharged())
+		{
+			if (this->distanceTo(Point) >= _swimprecision)
+				this->_swimToNearestFromHere(Point);
+		}
+		else
+			this->swimToStateNearest(Point);
+		return this->_chi2AtNearest(Point,XYDistance);
+	}
+	
+	void TrackState::chi2(const Vector3* Points, std::size_t NumPoints, double* Chi2)
+	{
+		//Neutral swims are analytic and don't depend on where they start
+		if (this->isNeutral())
+		{
+			for (std::size_t i = 0; i < NumPoints; ++i)
+				Chi2[i] = this->chi2(Points[i]);
+			return;
+		}
+		
+		bool Warm = false;
+		double XYSwum = 0.0;
+		for (std::size_t i = 0; i < NumPoints; ++i)
+		{
+			const Vector3 & Point = Points[i];
+			const double Swum = _DistanceSwum;
+			//Start from the XY solution of the previous point, falling back to the analytic one
+			if (Warm)
+			{
+				this->swimDistance(XYSwum - _DistanceSwum);
+				Warm = this->_swimToNearestXYFromHere(Point);
+			}
+			if (!Warm)
+				this->swimToStateNearestXY(Point);
+			XYSwum = _DistanceSwum;
+			double XYDistance = this->xyDistanceTo(Point);
+			
+			//And the 3D search from the 3D solution of the previous point
+			if (Warm)
+				this->swimDistance(Swum - _DistanceSwum);
+			if (Warm || this->distanceTo(Point) >= _swimprecision)
+				this->_swimToNearestFromHere(Point);
+			//A warm XY search can settle in a further minimum than the analytic one, which shows
+			//as the 3D point being nearer than the XY one, so start again from the analytic one
+			if (Warm && XYDistance - this->distanceTo(Point) >= _swimprecision)
+			{
+				this->swimToStateNearestXY(Point);
+				XYSwum = _DistanceSwum;
+				XYDistance = this->xyDistanceTo(Point);
+				if (this->distanceTo(Point) >= _swimprecision)
+					this->_swimToNearestFromHere(Point);
+			}
+			Chi2[i] = this->_chi2AtNearest(Point,XYDistance);
+			Warm = true;
+		}
+	}
+	
+	double TrackState::_chi2AtNearest(const Vector3 &Point, double XYDistance)
+	{
+		boost::numeric::ublas::bounded_vector<double,2> Residual;
+		Residual(0) = XYDistance;
 		//The 3Ddist , 2Ddist and distance on z plane form a right triangle, convert to zaxis by dividing by sin theta 
 		//Double check 3d is hypotenuse
 		//Our 2d might be shorter as it analytical and 3d is iterative so check within swimPrecision
@@ -361,15 +368,17 @@ namespace vertex_lcfi
 			else
 			{
 				std::cerr << "Warning trackstate.cpp:364:chi2 2D Distance to track was longer than 3D - swimming problem?" << std::endl;
+				//No Z residual to be had, take the chi squared from the XY one alone
+				Residual(1) = 0;
 			}
 		}
 		else //Everything normal 3D>2D
 		{	
 			//Residual(1) = (sqrt(this->distanceTo2(Point)-pow(Residual(0),2)))/(1.0/sqrt(1.0+pow(_Init.tanLambda(),2)));
-   			 Residual(1) = sqrt(this->distanceTo2(Point)-pow(Residual(0),2))*sqrt(pow(_Init.tanLambda(),2)+1.0); 
+   			 Residual(1) = sqrt(this->distanceTo2(Point)-pow(Residual(0),2))*_Init.secLambda(); 
 		}
 		
-		double chi2 = prec_inner_prod(trans(Residual),prec_prod(this->inversePositionCovarMatrix(), Residual));
+		double chi2 = quadraticForm(this->inversePositionCovarMatrix(), Residual(0), Residual(1));
 		
 		if (std::isnan(chi2))
 		{
@@ -400,7 +409,7 @@ namespace vertex_lcfi
 		else
 		{	
 			//Residual(1) = (sqrt(this->distanceTo2(Point)-pow(Residual(0),2)))/(1.0/sqrt(1.0+pow(_Init.tanLambda(),2)));
-   			 Residual(1) = sqrt(this->distanceTo2(Point)-pow(Residual(0),2))*sqrt(pow(_Init.tanLambda(),2)+1.0); 
+   			 Residual(1) = sqrt(this->distanceTo2(Point)-pow(Residual(0),2))*_Init.secLambda(); 
 			 
 			 //std::cout << "3D: " << this->distanceTo(Point) << std::endl ;
 			 //std::cout << "2D: " << Residual(0) << std::endl ;
@@ -409,7 +418,7 @@ namespace vertex_lcfi
 			 //std::cout << "Chi2: " << prec_inner_prod(trans(Residual),prec_prod(this->inversePositionCovarMatrix(), Residual))<< std::endl<< std::endl;
 			 
 		}
-		return prec_inner_prod(trans(Residual),prec_prod(this->inversePositionCovarMatrix(), Residual));
+		return quadraticForm(this->inversePositionCovarMatrix(), Residual(0), Residual(1));
 	}
 	/*const Vector3 & TrackState::momentum() const 
 	{
@@ -443,24 +452,12 @@ namespace vertex_lcfi
 		{
 			if (this->isCharged())
 			{
-				double phival = _Init.phi();
-				_Position.x() = -_Init.d0()*sin(phival) + (sin(phival)-sin(phival-_Init.invR()*_DistanceSwum))/_Init.invR();
-				// 		-d0        *Sin(phi)    + (Sin(phi)   -Sin(phi   -invr        *s            ))/invr
-				_Position.y() = _Init.d0()*cos(phival) + (-cos(phival)+cos(phival-_Init.invR()*_DistanceSwum))/_Init.invR();
-				//		d0        *Cos(phi)    + (-Cos(phi)   +Cos(phi   -invr        *s            ))/invr
-				//_Position.x() = (_Init.d0()*sin(phival)) + ((sin(phival)-sin(phival-(_DistanceSwum*(-_Init.invR()))))/(-_Init.invR()));
-				//_Position.y() = (-_Init.d0()*cos(phival)) + ((cos(phival-(_DistanceSwum*(-_Init.invR())))-cos(phival))/(-_Init.invR()));
-				_Position.z() = (_DistanceSwum*_Init.tanLambda()) + _Init.z0();
-				//std::cout << "Cswim " << _DistanceSwum << " to " <<_Position << std::endl;
-				
-				//_Position.x() = (_Init.d0()*sin(phival)) + ((sin(phival)-sin(phival-(_DistanceSwum*_Init.invR())))/_Init.invR());
-				//_Position.y() = (-_Init.d0()*cos(phival)) + ((cos(phival-(_DistanceSwum*_Init.invR()))-cos(phival))/_Init.invR());
-				//_Position.z() = (_DistanceSwum/tan(_Init.theta())) + _Init.z0();
+				_Init.positionAt(_DistanceSwum,_Position.x(),_Position.y(),_Position.z(),_SinPsi,_CosPsi);
 			}
 			if (this->isNeutral()) //TODO Check z
 			{
-				_Position.x() = (_Init.d0()*sin(_Init.phi())) + (_DistanceSwum*cos(_Init.phi()));
-				_Position.y() = (-_Init.d0()*cos(_Init.phi())) + (_DistanceSwum*sin(_Init.phi()));
+				_Position.x() = (_Init.d0()*_Init.sinPhi()) + (_DistanceSwum*_Init.cosPhi());
+				_Position.y() = (-_Init.d0()*_Init.cosPhi()) + (_DistanceSwum*_Init.sinPhi());
 				_Position.z() = (_DistanceSwum*_Init.tanLambda()) + _Init.z0();
 				//std::cout << "Nswim " << _DistanceSwum << " to " <<_Position << std::endl;
 			}
@@ -469,6 +466,17 @@ namespace vertex_lcfi
 		return _Position;
 	}
 	
+	Vector3 TrackState::direction() const
+	{
+		if (this->isCharged())
+		{
+			//position() keeps the XY direction up to date
+			this->position();
+			return Vector3(_CosPsi,_SinPsi,_Init.tanLambda());
+		}
+		return Vector3(_Init.cosPhi(),_Init.sinPhi(),_Init.tanLambda());
+	}
+	
 	const Matrix3x3 TrackState::vertexErrorContribution(Vector3 point) const
 	{
 		//std::cout << "*";std::cout.flush();
@@ -480,7 +488,7 @@ namespace vertex_lcfi
 		//PCA(2) =  PARK(3)*CPHI
 		//PCA(3) =  PARK(5)
 		//TL   = PARK(4)
-		double STHE = 1.0/sqrt(1.0+pow(_Init.tanLambda(),2));
+		double STHE = 1.0/_Init.secLambda();
 		double CTHE = STHE*_Init.tanLambda();
 		//std::cout << STHE << " " << CTHE << std::endl;
 		//*  calculate 3d PCA in this system.
@@ -501,10 +509,12 @@ namespace vertex_lcfi
 		//* ty = sin(theta)*sin(phi), and tz = cos(theta).
 		//* We use the fact that d0 and z0 are zero after the OUMOVE call.
 		//*
-		double DXDD = -sin(_Init.phi());
-		double DXDZ = -cos(_Init.phi())*STHE*CTHE;
-		double DYDD =  cos(_Init.phi());
-		double DYDZ = -sin(_Init.phi())*STHE*CTHE;
+		const double SPHI = _Init.sinPhi();
+		const double CPHI = _Init.cosPhi();
+		double DXDD = -SPHI;
+		double DXDZ = -CPHI*STHE*CTHE;
+		double DYDD =  CPHI;
+		double DYDZ = -SPHI*STHE*CTHE;
 		double DZDZ = pow(STHE,2);
 		//*	
 		//* calculate error matrix for this point.  Must transform from track
@@ -527,14 +537,14 @@ namespace vertex_lcfi
 		//*  set up rotation matrix to take track into w direction by matrix
 		//*  multiplication, vecnew_i = rot(i,j)vecold_j
 		Matrix3x3 ROTAT;
-		ROTAT(0,0)= CTHE*cos(_Init.phi());
-		ROTAT(0,1)= CTHE*sin(_Init.phi());
+		ROTAT(0,0)= CTHE*CPHI;
+		ROTAT(0,1)= CTHE*SPHI;
 		ROTAT(0,2)= -STHE;
-		ROTAT(1,0)= -sin(_Init.phi());
-		ROTAT(1,1)= cos(_Init.phi());
+		ROTAT(1,0)= -SPHI;
+		ROTAT(1,1)= CPHI;
 		ROTAT(1,2)= 0.0;
-		ROTAT(2,0)= STHE*cos(_Init.phi());
-		ROTAT(2,1)= STHE*sin(_Init.phi());
+		ROTAT(2,0)= STHE*CPHI;
+		ROTAT(2,1)= STHE*SPHI;
 		ROTAT(2,2)= CTHE;
 		//*  rotate track covariance into the new frame (uvw), where u and v are
 		//*  perpendicular to the track and w is along the track
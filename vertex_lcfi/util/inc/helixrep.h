@@ -39,7 +39,69 @@ class HelixRep
         inline double circum() const {return (_Changed ? _reCalculate(), _Circumference : _Circumference);}
         inline double halfCircum() const {return (_Changed ? _reCalculate(), _HalfCircumference : _HalfCircumference);}
         inline double zLength() const {return (_Changed ? _reCalculate(), _ZLength : _ZLength);}
+
+	//Trigonometric constants of the helix, cached with the others so swimming needs no sin/cos of phi
+        inline double sinPhi() const {return (_Changed ? _reCalculate(), _SinPhi : _SinPhi);}
+        inline double cosPhi() const {return (_Changed ? _reCalculate(), _CosPhi : _CosPhi);}
+        inline double radius() const {return (_Changed ? _reCalculate(), _Radius : _Radius);}
+	//Path length per unit of transverse length, sqrt(1+tanLambda^2)
+        inline double secLambda() const {return (_Changed ? _reCalculate(), _SecLambda : _SecLambda);}
         
+	//!Position a distance S along a charged helix from the reference point
+	/*!
+	SinPsi and CosPsi are set to the direction of the track there, psi = phi-invR.S.
+	Sin(phi-invR.S) and Cos(phi-invR.S) come from angle addition with the turn angle invR.S,
+	using 1-Cos(a) = 2Sin(a/2)^2 to keep precision on short swims.
+	*/
+	inline void positionAt(double S, double & X, double & Y, double & Z, double & SinPsi, double & CosPsi) const
+	{
+		const double SinPhi = sinPhi();
+		const double CosPhi = cosPhi();
+		const double HalfTurn = 0.5*_InvR*S;
+		const double SinHalfTurn = sin(HalfTurn);
+		const double SinTurn = 2.0*SinHalfTurn*cos(HalfTurn);
+		const double VersTurn = 2.0*SinHalfTurn*SinHalfTurn;
+		const double DSin = SinPhi*VersTurn + CosPhi*SinTurn;	//Sin(phi)-Sin(phi-invr*s)
+		const double DCos = SinPhi*SinTurn - CosPhi*VersTurn;	//Cos(phi-invr*s)-Cos(phi)
+		SinPsi = SinPhi - DSin;
+		CosPsi = CosPhi + DCos;
+		X = -_d0*SinPhi + DSin*radius();
+		Y = _d0*CosPhi + DCos*radius();
+		Z = (S*_TanLambda) + _z0;
+	}
+	
+	//!Distance along a charged helix from the reference point to the closest approach to a point in XY
+	/*!
+	Of the two points round the circle level with (PX,PY) the nearer is taken, in the helix
+	cycle nearest PZ as some procedures use a z measurement from the XY point of closest approach.
+	\return 0 if the reference point is already within Precision of the point in XY
+	*/
+	inline double xyPocaDistance(double PX, double PY, double PZ, double Precision) const
+	{
+		double X,Y,Z,SinPsi,CosPsi;
+		this->positionAt(0.0,X,Y,Z,SinPsi,CosPsi);
+		if (sqrt(pow(X-PX,2) + pow(Y-PY,2)) < Precision)
+			return 0.0;
+		//The point relative to the center of the circle in the XY plane
+		const double P2X = PX - (X + (sinPhi()*radius()));
+		const double P2Y = PY - (Y - (cosPhi()*radius()));
+		//d distance to point on circle / ds solved for zero points gives a distance relative
+		//to the top of the circle, whereas the refpoint is phi dependant
+		double S = 0.0;
+		S += (atan(P2X/P2Y)/_InvR) + (_Phi/_InvR);
+		this->positionAt(S,X,Y,Z,SinPsi,CosPsi);
+		const double Dist1 = sqrt(pow(X-PX,2) + pow(Y-PY,2));
+		//The second point 180 degrees away, swim back if the first was the best
+		S += halfCircum();
+		this->positionAt(S,X,Y,Z,SinPsi,CosPsi);
+		const double Dist2 = sqrt(pow(X-PX,2) + pow(Y-PY,2));
+		if (Dist1 < Dist2) S += -halfCircum();
+		//Work out how many cycles away we are in z and swim back the opposite
+		this->positionAt(S,X,Y,Z,SinPsi,CosPsi);
+		S += -circum() * round((Z-PZ) / zLength());
+		return S;
+	}
+	
 	private:
 	double _d0;
 	double _z0;
@@ -52,6 +114,10 @@ class HelixRep
 	mutable double _Circumference=0.0;
 	mutable double _HalfCircumference=0.0;
 	mutable double _ZLength=0.0;
+	mutable double _SinPhi=0.0;
+	mutable double _CosPhi=1.0;
+	mutable double _Radius=1.0;
+	mutable double _SecLambda=1.0;
 	void _reCalculate() const
 	{
 		_Changed = false;
@@ -59,6 +125,10 @@ class HelixRep
 		_Circumference = 2.0*3.141592654/invR();
 		_HalfCircumference = 3.141592654/invR();
 		_ZLength = _Circumference*tanLambda();
+		_SinPhi = sin(_Phi);
+		_CosPhi = cos(_Phi);
+		_Radius = 1.0/_InvR;
+		_SecLambda = sqrt(1.0+(_TanLambda*_TanLambda));
 	}
 };
 
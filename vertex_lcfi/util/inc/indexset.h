@@ -0,0 +1,129 @@
+#ifndef LCFIINDEXSET_H
+#define LCFIINDEXSET_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace vertex_lcfi{
+namespace util{
+
+	//! Set of small non-negative integers held as a bitset
+	/*!
+	The first 128 indices are held in the object itself, so sets of the tracks of a jet
+	need no memory of their own, larger indices go in words allocated as needed.
+	Membership is a single bit test and intersection is word by word.
+	*/
+	class IndexSet
+	{
+	public:
+		//! Whether Index is in the set
+		inline bool contains(std::size_t Index) const
+		{
+			const std::size_t Word = Index/64;
+			if (Word < _NumInline)
+				return (_Inline[Word] >> (Index%64)) & 1u;
+			return (Word-_NumInline < _Overflow.size()) && ((_Overflow[Word-_NumInline] >> (Index%64)) & 1u);
+		}
+
+		//! Add Index to the set
+		inline void insert(std::size_t Index)
+		{
+			this->_word(Index) |= (std::uint64_t(1) << (Index%64));
+		}
+
+		//! Remove Index from the set
+		inline void erase(std::size_t Index)
+		{
+			const std::size_t Word = Index/64;
+			if (Word < _NumInline)
+				_Inline[Word] &= ~(std::uint64_t(1) << (Index%64));
+			else if (Word-_NumInline < _Overflow.size())
+				_Overflow[Word-_NumInline] &= ~(std::uint64_t(1) << (Index%64));
+		}
+
+		//! Remove every index
+		inline void clear()
+		{
+			for (std::size_t i = 0; i < _NumInline; ++i)
+				_Inline[i] = 0;
+			_Overflow.clear();
+		}
+
+		//! Whether the two sets have an index in common
+		inline bool intersects(const IndexSet & Other) const
+		{
+			for (std::size_t i = 0; i < _NumInline; ++i)
+				if (_Inline[i] & Other._Inline[i])
+					return true;
+			const std::size_t NumOverflow = (_Overflow.size() < Other._Overflow.size()) ? _Overflow.size() : Other._Overflow.size();
+			for (std::size_t i = 0; i < NumOverflow; ++i)
+				if (_Overflow[i] & Other._Overflow[i])
+					return true;
+			return false;
+		}
+
+		//! Whether the set holds no index
+		inline bool empty() const
+		{
+			for (std::size_t i = 0; i < _NumInline; ++i)
+				if (_Inline[i])
+					return false;
+			for (std::size_t i = 0; i < _Overflow.size(); ++i)
+				if (_Overflow[i])
+					return false;
+			return true;
+		}
+
+		//! Indices in both this set and Other
+		inline IndexSet intersection(const IndexSet & Other) const
+		{
+			IndexSet Result;
+			for (std::size_t i = 0; i < _NumInline; ++i)
+				Result._Inline[i] = _Inline[i] & Other._Inline[i];
+			const std::size_t NumOverflow = (_Overflow.size() < Other._Overflow.size()) ? _Overflow.size() : Other._Overflow.size();
+			Result._Overflow.resize(NumOverflow);
+			for (std::size_t i = 0; i < NumOverflow; ++i)
+				Result._Overflow[i] = _Overflow[i] & Other._Overflow[i];
+			return Result;
+		}
+
+		//! Add every index of Other
+		inline void insert(const IndexSet & Other)
+		{
+			for (std::size_t i = 0; i < _NumInline; ++i)
+				_Inline[i] |= Other._Inline[i];
+			if (_Overflow.size() < Other._Overflow.size())
+				_Overflow.resize(Other._Overflow.size(),0);
+			for (std::size_t i = 0; i < Other._Overflow.size(); ++i)
+				_Overflow[i] |= Other._Overflow[i];
+		}
+
+		//! Remove every index of Other
+		inline void erase(const IndexSet & Other)
+		{
+			for (std::size_t i = 0; i < _NumInline; ++i)
+				_Inline[i] &= ~Other._Inline[i];
+			const std::size_t NumOverflow = (_Overflow.size() < Other._Overflow.size()) ? _Overflow.size() : Other._Overflow.size();
+			for (std::size_t i = 0; i < NumOverflow; ++i)
+				_Overflow[i] &= ~Other._Overflow[i];
+		}
+
+	private:
+		inline std::uint64_t & _word(std::size_t Index)
+		{
+			const std::size_t Word = Index/64;
+			if (Word < _NumInline)
+				return _Inline[Word];
+			if (Word-_NumInline >= _Overflow.size())
+				_Overflow.resize(Word-_NumInline+1,0);
+			return _Overflow[Word-_NumInline];
+		}
+
+		static const std::size_t _NumInline = 2;
+		std::uint64_t _Inline[_NumInline] = {0,0};
+		std::vector<std::uint64_t> _Overflow{};
+	};
+}
+}
+#endif //LCFIINDEXSET_H
@@ -218,6 +218,67 @@ double determinant(Matrix3x3 input);
 SymMatrix5x5 InvertMatrix5x5(SymMatrix5x5 input);
 Matrix3x3 InvertMatrix(Matrix3x3 input);//const ublas::matrix<T>& input, ublas::matrix<T>& inverse) 
 Matrix2x2 InvertMatrix2(Matrix2x2 input);//const ublas::matrix<T>& input, ublas::matrix<T>& inverse) 
+SymMatrix3x3 InvertSymMatrix3x3(const SymMatrix3x3 & input);
+
+//Fixed size kernels working directly on the matrix storage, for the inner loops.
+//Symmetric matrices are packed lower row major so (i,j) i>=j is at i*(i+1)/2+j.
+//Accumulation is in double (prec_prod uses long double) so results agree to rounding.
+
+//! r.M.r for a symmetric 2x2 matrix
+inline double quadraticForm(const SymMatrix2x2 & M, const double r0, const double r1)
+{
+	const double* m = &M.data()[0];
+	const double t0 = m[0]*r0 + m[1]*r1;
+	const double t1 = m[1]*r0 + m[2]*r1;
+	return r0*t0 + r1*t1;
+}
+
+//! r.M.r for a symmetric 3x3 matrix, r can be any 3 vector with operator()
+template<class V>
+inline double quadraticForm(const SymMatrix3x3 & M, const V & r)
+{
+	const double* m = &M.data()[0];
+	const double r0 = r(0), r1 = r(1), r2 = r(2);
+	const double t0 = m[0]*r0 + m[1]*r1 + m[3]*r2;
+	const double t1 = m[1]*r0 + m[2]*r1 + m[4]*r2;
+	const double t2 = m[3]*r0 + m[4]*r1 + m[5]*r2;
+	return r0*t0 + r1*t1 + r2*t2;
+}
+
+//! r.M.r for a 3x3 matrix, r can be any 3 vector with operator()
+template<class V>
+inline double quadraticForm(const Matrix3x3 & M, const V & r)
+{
+	const double* m = &M.data()[0];
+	const double r0 = r(0), r1 = r(1), r2 = r(2);
+	const double t0 = m[0]*r0 + m[1]*r1 + m[2]*r2;
+	const double t1 = m[3]*r0 + m[4]*r1 + m[5]*r2;
+	const double t2 = m[6]*r0 + m[7]*r1 + m[8]*r2;
+	return r0*t0 + r1*t1 + r2*t2;
+}
+
+//! M += c.a.a^T for a symmetric 3x3 matrix, a can be any 3 vector with operator()
+template<class V>
+inline void addOuterProduct(SymMatrix3x3 & M, const double c, const V & a)
+{
+	double* m = &M.data()[0];
+	const double a0 = a(0), a1 = a(1), a2 = a(2);
+	m[0] += c*a0*a0;
+	m[1] += c*a1*a0; m[2] += c*a1*a1;
+	m[3] += c*a2*a0; m[4] += c*a2*a1; m[5] += c*a2*a2;
+}
+
+//! M += c.(a.b^T + b.a^T) for a symmetric 3x3 matrix
+template<class V, class W>
+inline void addOuterProduct(SymMatrix3x3 & M, const double c, const V & a, const W & b)
+{
+	double* m = &M.data()[0];
+	const double a0 = a(0), a1 = a(1), a2 = a(2);
+	const double b0 = b(0), b1 = b(1), b2 = b(2);
+	m[0] += c*2.0*a0*b0;
+	m[1] += c*(a1*b0 + b1*a0); m[2] += c*2.0*a1*b1;
+	m[3] += c*(a2*b0 + b2*a0); m[4] += c*(a2*b1 + b2*a1); m[5] += c*2.0*a2*b2;
+}
 
 #ifdef DOMATRIX
 /*
@@ -2,6 +2,12 @@
 #define LCFIMEMMANAGE_H
 
 #include <vector>
+#include <string>
+#include <ostream>
+#include <typeinfo>
+#include <new>
+#include <utility>
+#include <type_traits>
 
 namespace vertex_lcfi
 {
@@ -14,25 +20,83 @@ namespace vertex_lcfi
 			{}
 			//! Delete all objects that this MemoryManger has pointers to
 			virtual void delAll() =0;
+			//! Number of objects currently held
+			virtual std::size_t objectCount() const =0;
+			//! Number of the objects currently held that were made in the arena by make()
+			virtual std::size_t arenaObjectCount() const =0;
+			//! Size in bytes of one object of the managed type
+			virtual std::size_t objectSize() const =0;
+			//! Compiler name of the managed type
+			virtual const char* typeName() const =0;
+	};
+	
+	//! Statistics of one managed type - see MetaMemoryManager::enableStatistics
+	/*!
+	Counts are taken when MetaMemoryManager::delAllObjects is called and kept apart for
+	each label it is called with, bytes are estimated as count*ObjectSize so don't include
+	memory owned by the objects. As objects live until the cleanup, the count at each
+	cleanup is the number made since the one before, by make() or registerObject().
+	*/
+	struct MemoryStatistics
+	{
+		//! Label passed to delAllObjects, usually the name of the processor, empty if none
+		std::string Label{};
+		//! delAllObjects calls with this label
+		unsigned long Cleanups=0;
+		//! Demangled name of the type
+		std::string TypeName{};
+		//! sizeof the type
+		std::size_t ObjectSize=0;
+		//! Objects held at the last delAllObjects
+		std::size_t LastCount=0;
+		//! Most objects held at any one delAllObjects
+		std::size_t PeakCount=0;
+		//! The delAllObjects call with this label (counting from 1) at which PeakCount was seen
+		unsigned long PeakCleanup=0;
+		//! Sum of the objects held over all delAllObjects calls with this label
+		unsigned long long TotalCount=0;
+		//! Sum over the same calls of the objects made by make(), the rest were allocated by the caller and registered
+		unsigned long long TotalMade=0;
 	};
 	
 	//! MemoryManager Controller - see MemoryManager
 	/*!
 	Keeps track of MemoryManagers for each type, and tells them to delete
 	their objects when delAllObjects is called.
+	<br>There is one Event and one Run instance per thread, so objects made on one
+	thread are never deleted by another.
 	*/
 	class MetaMemoryManager
 	{
 	public:
-		//! Returns the Event duration singleton instance of the controller
+		//! Returns the Event duration instance of the controller for the calling thread
 		static MetaMemoryManager* Event();
-		//! Returns the Run duration singleton instance of the controller
+		//! Returns the Run duration instance of the controller for the calling thread
 		static MetaMemoryManager* Run();
 		//! Delete all objects of all types held by this instance
-		void delAllObjects();
+		/*!
+		\param Label Statistics of this cleanup are recorded under Label, usually the name of the
+		processor clearing up, so that processors sharing the managers can be told apart
+		*/
+		void delAllObjects(const std::string & Label = std::string());
 		//! Used by the MemoryManager of each type to alert the controller of its existance
 		void registerType(MemoryManagerType* Type);
 		
+		//! Record per type statistics at each delAllObjects, off by default
+		void enableStatistics(bool Enable = true);
+		//! Are statistics being recorded
+		bool statisticsEnabled() const;
+		//! Clear recorded statistics
+		void resetStatistics();
+		//! Number of delAllObjects calls recorded under all labels
+		unsigned long numCleanups() const;
+		//! Statistics for each label and type that has held objects, by label in the order first seen
+		std::vector<MemoryStatistics> statistics() const;
+		//! Print statistics as a table
+		void printStatistics(std::ostream & Out) const;
+		//! Print statistics as comma separated values with a header line
+		void writeStatistics(std::ostream & Out) const;
+		
 	protected:
 		//! Do not use
 		MetaMemoryManager();
@@ -42,6 +106,43 @@ namespace vertex_lcfi
 		MetaMemoryManager& operator= (const MetaMemoryManager&);
 	private:
 		std::vector<MemoryManagerType*> _Types{};
+		
+		//Statistics of each label, the types in the same order as _Types
+		struct LabelStatistics
+		{
+			std::string Label;
+			unsigned long NumCleanups;
+			std::vector<MemoryStatistics> Types;
+		};
+		bool _StatisticsEnabled=false;
+		unsigned long _NumCleanups=0;
+		std::vector<LabelStatistics> _Statistics{};
+	};
+	
+	//! Scoped cleanup of event lifetime objects
+	/*!
+	Deletes all event lifetime objects made on the calling thread when it goes out of scope,
+	including when an exception is thrown. Declare one at the start of the work for each event,
+	with a label for the statistics (see MetaMemoryManager::delAllObjects):
+	<br><pre>EventScope Scope(name());</pre>
+	<br>As the MemoryManagers are per thread, independent events or jets can then be processed
+	concurrently on worker threads, each with its own EventScope.
+	*/
+	class EventScope
+	{
+	public:
+		//! Constructor
+		explicit EventScope(const std::string & Label = std::string())
+		: _Label(Label)
+		{}
+		//! Destructor - calls MetaMemoryManager::Event()->delAllObjects(Label)
+		~EventScope();
+	private:
+		std::string _Label;
+		//! Do not use
+		EventScope(const EventScope&);
+		//! Do not use
+		EventScope& operator= (const EventScope&);
 	};
 
 	//!Memory management
@@ -53,6 +154,11 @@ namespace vertex_lcfi
 	<br>At the end of the event to free all objects of all types made using the above call:
 	<br><pre>MetaMemoryManager::Event()->delAllObjects();</pre>
 	<br>Similarly for run lifetime objects, replacing %Event with Run.
+	<br>Objects can instead be constructed directly in the managers arena, which avoids a heap
+	allocation per object:
+	<br><pre>myType* myObject = MemoryManager<myType>::Event()->make(construction parameters);</pre>
+	<br>The arena is a list of fixed size blocks which are kept between events, so releasing it
+	is O(1) for trivially destructible types, otherwise each arena object has its destructor run.
 	*/
 	template <class T>
 	class MemoryManager :
@@ -61,14 +167,34 @@ namespace vertex_lcfi
 	public:
 		//! Destructor - will delete all held objects
 		virtual ~MemoryManager();
-		//! Returns the Event duration singleton instance of the MemoryManager for type T
+		//! Returns the Event duration instance of the MemoryManager for type T for the calling thread
 		static MemoryManager<T>* Event();
-		//! Returns the Run duration singleton instance of the MemoryManager for type T
+		//! Returns the Run duration instance of the MemoryManager for type T for the calling thread
 		static MemoryManager<T>* Run();	
 		//! Register an object for memory management
 		void registerObject(T* pointer);
+		//! Construct an object in the arena of this MemoryManager
+		/*!
+		The object lives until delAll is called, don't delete this pointer!
+		\param args Arguments forwarded to the constructor of T
+		\return A pointer to the new object
+		*/
+		template <class... Args>
+		T* make(Args&&... args);
 		//! Delete all objects held by this MemoryManager
 		void delAll();
+		//! Number of objects currently held
+		std::size_t objectCount() const
+		{return _Objects.size() + _ArenaUsed;}
+		//! Number of objects made by make() since delAll
+		std::size_t arenaObjectCount() const
+		{return _ArenaUsed;}
+		//! Size in bytes of one T
+		std::size_t objectSize() const
+		{return sizeof(T);}
+		//! Compiler name of T
+		const char* typeName() const
+		{return typeid(T).name();}
 	//Protect the constructor, copy and assignment to prevent usage.		
 	protected:
 		//! Do not use
@@ -80,6 +206,12 @@ namespace vertex_lcfi
 	private:
 		std::vector<T*> _Objects{};
 		
+		//Arena storage, each block holds _BlockSize objects
+		static const std::size_t _BlockSize = 256;
+		std::vector<T*> _Blocks{};
+		//Number of arena slots in use, filled in order
+		std::size_t _ArenaUsed=0;
+		
 	};
 	
 	template <class T>
@@ -87,21 +219,26 @@ namespace vertex_lcfi
 	{
 	//Delete all in case the user hasn't done so
 	this->delAll();
+	for(typename std::vector<T*>::iterator iB = _Blocks.begin();iB != _Blocks.end();++iB)
+		::operator delete(static_cast<void*>(*iB));
 	}
 	
 	template <class T>
 	MemoryManager<T>* MemoryManager<T>::Event()
 	{
-		static MemoryManager<T> eventInstance;
-		MetaMemoryManager::Event()->registerType(&eventInstance);
+		static thread_local MemoryManager<T> eventInstance;
+		//Only alert the controller once, this is called for every object
+		static thread_local const bool registered = (MetaMemoryManager::Event()->registerType(&eventInstance), true);
+		(void)registered;
 		return &eventInstance;
 	}
 	
 	template <class T>
 	MemoryManager<T>* MemoryManager<T>::Run()
 	{
-		static MemoryManager<T> runInstance;
-		MetaMemoryManager::Run()->registerType(&runInstance);
+		static thread_local MemoryManager<T> runInstance;
+		static thread_local const bool registered = (MetaMemoryManager::Run()->registerType(&runInstance), true);
+		(void)registered;
 		return &runInstance;
 	}
 
@@ -111,6 +248,18 @@ namespace vertex_lcfi
 		_Objects.push_back(pointer);
 	}
 	
+	template <class T>
+	template <class... Args>
+	T* MemoryManager<T>::make(Args&&... args)
+	{
+		const std::size_t block = _ArenaUsed / _BlockSize;
+		if (block == _Blocks.size())
+			_Blocks.push_back(static_cast<T*>(::operator new(_BlockSize*sizeof(T))));
+		T* pointer = new (_Blocks[block] + (_ArenaUsed % _BlockSize)) T(std::forward<Args>(args)...);
+		++_ArenaUsed;
+		return pointer;
+	}
+	
 	template <class T>
 	void MemoryManager<T>::delAll()
 	{
@@ -120,6 +269,14 @@ namespace vertex_lcfi
 			delete (*iP);
 		}
 		_Objects.clear();
+		
+		//Arena blocks are kept for the next event, only destructors need running
+		if (!std::is_trivially_destructible<T>::value)
+		{
+			for (std::size_t i = 0; i < _ArenaUsed; ++i)
+				(_Blocks[i / _BlockSize] + (i % _BlockSize))->~T();
+		}
+		_ArenaUsed = 0;
 	}
 
 
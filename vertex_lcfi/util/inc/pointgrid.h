@@ -0,0 +1,51 @@
+#ifndef LCFIPOINTGRID_H
+#define LCFIPOINTGRID_H
+
+#include "vector3.h"
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace vertex_lcfi{
+namespace util{
+
+	//! Uniform grid over a fixed set of points for finding those near a position
+	/*!
+	The points are binned into cubic cells at least as large as the search radius
+	so a search only looks at the 27 cells about the position. The cells are kept
+	as one sorted array rather than a map, the grid is built once and searched many times.
+	<br>The grid keeps its own copy of the points and refers to them by their index in
+	the vector it was built from.
+	*/
+	class PointGrid
+	{
+	public:
+		//! Bin the points
+		/*!
+		\param Points Points to search, copied
+		\param Radius Largest radius that will be searched for, mm
+		*/
+		PointGrid(const std::vector<Vector3> & Points, double Radius);
+
+		//! Indices of the points no further than Radius from Position, in ascending order
+		/*!
+		\param Position Centre of the search
+		\param Radius Radius of the search, no larger than the one the grid was built for
+		\param Indices Cleared and filled with the indices found
+		*/
+		void pointsWithin(const Vector3 & Position, double Radius, std::vector<std::size_t> & Indices) const;
+
+	private:
+		std::uint64_t _cellKey(std::int64_t i, std::int64_t j, std::int64_t k) const;
+		void _cellOf(const Vector3 & Position, std::int64_t & i, std::int64_t & j, std::int64_t & k) const;
+
+		std::vector<Vector3> _Points{};
+		Vector3 _Origin{};
+		double _CellSize=0.0;
+		//Cell key and point index, sorted by key
+		std::vector<std::pair<std::uint64_t,std::size_t> > _Cells{};
+	};
+}
+}
+#endif //LCFIPOINTGRID_H
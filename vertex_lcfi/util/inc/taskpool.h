@@ -0,0 +1,70 @@
+#ifndef LCFITASKPOOL_H
+#define LCFITASKPOOL_H
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+namespace vertex_lcfi{
+namespace util{
+
+	//! Pool of threads running numbered tasks with work stealing
+	/*!
+	run() shares the task numbers 0 to NumTasks-1 out as one contiguous range per worker.
+	Each worker takes tasks from the front of its own range, and when that is empty takes
+	the back half of the largest range left, so uneven tasks still keep every worker busy.
+	The calling thread is worker 0, the others are kept waiting between calls.
+	<br>Which worker runs which task is not fixed, so tasks must only write to their own
+	results; anything a worker needs to itself is chosen by the Worker number passed in.
+	<br>run() must not be called from inside a task or from two threads at once.
+	*/
+	class TaskPool
+	{
+	public:
+		//! Signature of a task, called with the task and worker numbers
+		typedef std::function<void(std::size_t Task, unsigned int Worker)> Task;
+
+		//! Start the pool
+		/*!
+		\param NumThreads Number of workers including the caller, 0 for one per hardware thread
+		*/
+		explicit TaskPool(unsigned int NumThreads = 0);
+		~TaskPool();
+		TaskPool(const TaskPool&) = delete;
+		TaskPool& operator=(const TaskPool&) = delete;
+
+		//! Number of workers including the caller
+		inline unsigned int numWorkers() const
+		{return unsigned(_Ranges.size());}
+
+		//! Run Function for each task number from 0 to NumTasks-1 and wait for them all
+		void run(std::size_t NumTasks, const Task & Function);
+
+	private:
+		struct Range
+		{
+			std::mutex Mutex;
+			std::size_t Begin=0;
+			std::size_t End=0;
+		};
+
+		void _work(unsigned int Worker);
+		bool _next(unsigned int Worker, std::size_t & Task);
+		void _loop(unsigned int Worker);
+
+		std::vector<Range> _Ranges;
+		std::vector<std::thread> _Threads{};
+		std::mutex _Mutex{};
+		std::condition_variable _Start{};
+		std::condition_variable _Done{};
+		const Task* _Function=nullptr;
+		unsigned long _Generation=0;
+		unsigned int _Busy=0;
+		bool _Stop=false;
+	};
+}
+}
+#endif //LCFITASKPOOL_H
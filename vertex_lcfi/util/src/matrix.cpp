@@ -62,31 +62,18 @@ Matrix3x3 InvertMatrix(Matrix3x3 a)//const ublas::matrix<T>& input, ublas::matri
 	
 	for (short j=0;j<3;j++) 
 	{
+		//The two columns left when column j is removed
+		const short j0 = (j==0) ? 1 : 0;
+		const short j1 = (j==2) ? 1 : 2;
 		for (short i=0;i<3;i++) 
 		{
-
-			//Form the adjoint a_ij */
-         		matrix<double> c(2,2);
-			short i1 = 0;
-			for (short ii=0;ii<3;ii++) 
-				{
-					if (ii == i)
-						continue;
-					short j1 = 0;
-					for (short jj=0;jj<3;jj++) 
-					{
-						if (jj == j)
-							continue;
-						c(i1,j1) = a(ii,jj);
-						j1++;
-					}
-					i1++;
-				}
-
-				/* Calculate the determinate */
-				double tempdet = (c(0,0)*c(1,1)) - (c(1,0)*c(0,1));
-				/* Fill in the elements of the cofactor */
-				inverse(j,i) = (pow(-1.0,i+j+2.0) * tempdet)/det; //Note inline transposition
+			//And the two rows left when row i is removed
+			const short i0 = (i==0) ? 1 : 0;
+			const short i1 = (i==2) ? 1 : 2;
+			/* Calculate the determinate of the minor */
+			double tempdet = (a(i0,j0)*a(i1,j1)) - (a(i1,j0)*a(i0,j1));
+			/* Fill in the elements of the cofactor */
+			inverse(j,i) = (((i+j)%2) ? -tempdet : tempdet)/det; //Note inline transposition
 		}
 	}
 	//std::cout << inverse <<std::endl<<std::endl;
@@ -116,6 +103,29 @@ Matrix3x3 InvertMatrix(Matrix3x3 a)//const ublas::matrix<T>& input, ublas::matri
 	*/
 }
 
+SymMatrix3x3 InvertSymMatrix3x3(const SymMatrix3x3 & input)
+{
+	//Cofactors of the packed lower triangle
+	const double* m = &input.data()[0];
+	const double a00 = m[0], a10 = m[1], a11 = m[2], a20 = m[3], a21 = m[4], a22 = m[5];
+	const double c00 = a11*a22 - a21*a21;
+	const double c10 = a20*a21 - a10*a22;
+	const double c11 = a00*a22 - a20*a20;
+	const double c20 = a10*a21 - a11*a20;
+	const double c21 = a10*a20 - a00*a21;
+	const double c22 = a00*a11 - a10*a10;
+	const double invdet = 1.0/(a00*c00 + a10*c10 + a20*c20);
+	SymMatrix3x3 inverse;
+	double* r = &inverse.data()[0];
+	r[0] = c00*invdet;
+	r[1] = c10*invdet;
+	r[2] = c11*invdet;
+	r[3] = c20*invdet;
+	r[4] = c21*invdet;
+	r[5] = c22*invdet;
+	return inverse;
+}
+
 Matrix2x2 InvertMatrix2(Matrix2x2 a)//const ublas::matrix<T>& input, ublas::matrix<T>& inverse) 
 {
 	Matrix2x2 inverse;
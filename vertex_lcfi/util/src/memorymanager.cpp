@@ -1,25 +1,76 @@
 #include <util/inc/memorymanager.h>
+#include <iomanip>
+#include <cstdlib>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
 
 namespace vertex_lcfi
 {
 	
+	namespace
+	{
+		std::string demangle(const char* Name)
+		{
+#ifdef __GNUC__
+			int status = 0;
+			char* demangled = abi::__cxa_demangle(Name, 0, 0, &status);
+			if (demangled)
+			{
+				std::string result(demangled);
+				std::free(demangled);
+				return result;
+			}
+#endif
+			return Name;
+		}
+	}
+	
 	MetaMemoryManager::MetaMemoryManager()
 	{}
 	
 	MetaMemoryManager* MetaMemoryManager::Event() 
 	{
-		static MetaMemoryManager eventInstance;
+		static thread_local MetaMemoryManager eventInstance;
 		return &eventInstance;
 	}
   
 	MetaMemoryManager* MetaMemoryManager::Run() 
 	{
-		static MetaMemoryManager runInstance;
+		static thread_local MetaMemoryManager runInstance;
 		return &runInstance;
 	}
   
-	void MetaMemoryManager::delAllObjects()
+	void MetaMemoryManager::delAllObjects(const std::string & Label)
 	{
+		if (_StatisticsEnabled)
+		{
+			++_NumCleanups;
+			//Few labels, one per processor, so a search is enough
+			std::vector<LabelStatistics>::iterator iLabel = _Statistics.begin();
+			while (iLabel != _Statistics.end() && iLabel->Label != Label)
+				++iLabel;
+			if (iLabel == _Statistics.end())
+			{
+				LabelStatistics New = {Label,0,std::vector<MemoryStatistics>()};
+				iLabel = _Statistics.insert(_Statistics.end(),New);
+			}
+			const unsigned long Cleanup = ++iLabel->NumCleanups;
+			iLabel->Types.resize(_Types.size());
+			for (std::size_t i = 0; i < _Types.size(); ++i)
+			{
+				MemoryStatistics & Stats = iLabel->Types[i];
+				const std::size_t Count = _Types[i]->objectCount();
+				Stats.LastCount = Count;
+				Stats.TotalCount += Count;
+				Stats.TotalMade += _Types[i]->arenaObjectCount();
+				if (Count > Stats.PeakCount)
+				{
+					Stats.PeakCount = Count;
+					Stats.PeakCleanup = Cleanup;
+				}
+			}
+		}
 		for(std::vector<MemoryManagerType*>::iterator iMem = _Types.begin();iMem != _Types.end();++iMem)
 			(*iMem)->delAll();
 	}
@@ -29,6 +80,102 @@ namespace vertex_lcfi
 		_Types.push_back(Type);
 	}
 	
+	void MetaMemoryManager::enableStatistics(bool Enable)
+	{
+		_StatisticsEnabled = Enable;
+	}
+	
+	bool MetaMemoryManager::statisticsEnabled() const
+	{
+		return _StatisticsEnabled;
+	}
+	
+	void MetaMemoryManager::resetStatistics()
+	{
+		_NumCleanups = 0;
+		_Statistics.clear();
+	}
+	
+	unsigned long MetaMemoryManager::numCleanups() const
+	{
+		return _NumCleanups;
+	}
+	
+	std::vector<MemoryStatistics> MetaMemoryManager::statistics() const
+	{
+		std::vector<MemoryStatistics> Result;
+		for (std::vector<LabelStatistics>::const_iterator iLabel = _Statistics.begin(); iLabel != _Statistics.end(); ++iLabel)
+		{
+			for (std::size_t i = 0; i < iLabel->Types.size(); ++i)
+			{
+				//Skip types that have never held anything
+				if (iLabel->Types[i].PeakCount == 0)
+					continue;
+				MemoryStatistics Stats = iLabel->Types[i];
+				Stats.Label = iLabel->Label;
+				Stats.Cleanups = iLabel->NumCleanups;
+				Stats.TypeName = demangle(_Types[i]->typeName());
+				Stats.ObjectSize = _Types[i]->objectSize();
+				Result.push_back(Stats);
+			}
+		}
+		return Result;
+	}
+	
+	void MetaMemoryManager::printStatistics(std::ostream & Out) const
+	{
+		const std::vector<MemoryStatistics> Stats = this->statistics();
+		const std::ios::fmtflags Flags = Out.flags();
+		const std::streamsize Precision = Out.precision();
+		Out << "MemoryManager statistics over " << _NumCleanups << " cleanups" << std::endl;
+		for (std::vector<MemoryStatistics>::const_iterator iS = Stats.begin(); iS != Stats.end(); ++iS)
+		{
+			//A heading for each label
+			if (iS == Stats.begin() || iS->Label != (iS-1)->Label)
+			{
+				Out << (iS->Label.empty() ? "(no label)" : iS->Label) << ", " << iS->Cleanups << " cleanups" << std::endl;
+				Out << std::setw(10) << "Size" << std::setw(12) << "Last" << std::setw(12) << "Peak"
+				    << std::setw(14) << "Peak bytes" << std::setw(12) << "Peak at" << std::setw(14) << "Mean"
+				    << std::setw(14) << "Made/cleanup" << "  Type" << std::endl;
+			}
+			Out << std::setw(10) << iS->ObjectSize
+			    << std::setw(12) << iS->LastCount
+			    << std::setw(12) << iS->PeakCount
+			    << std::setw(14) << iS->PeakCount*iS->ObjectSize
+			    << std::setw(12) << iS->PeakCleanup
+			    << std::setw(14) << std::fixed << std::setprecision(1) << double(iS->TotalCount)/double(iS->Cleanups)
+			    << std::setw(14) << double(iS->TotalMade)/double(iS->Cleanups)
+			    << "  " << iS->TypeName << std::endl;
+		}
+		Out.flags(Flags);
+		Out.precision(Precision);
+	}
+	
+	void MetaMemoryManager::writeStatistics(std::ostream & Out) const
+	{
+		const std::vector<MemoryStatistics> Stats = this->statistics();
+		Out << "label,type,size,last,peak,peak_bytes,peak_cleanup,total,made,cleanups" << std::endl;
+		for (std::vector<MemoryStatistics>::const_iterator iS = Stats.begin(); iS != Stats.end(); ++iS)
+		{
+			//Type names contain commas in template arguments
+			Out << "\"" << iS->Label << "\","
+			    << "\"" << iS->TypeName << "\","
+			    << iS->ObjectSize << ","
+			    << iS->LastCount << ","
+			    << iS->PeakCount << ","
+			    << iS->PeakCount*iS->ObjectSize << ","
+			    << iS->PeakCleanup << ","
+			    << iS->TotalCount << ","
+			    << iS->TotalMade << ","
+			    << iS->Cleanups << std::endl;
+		}
+	}
+	
+	EventScope::~EventScope()
+	{
+		MetaMemoryManager::Event()->delAllObjects(_Label);
+	}
+	
 }
 
 
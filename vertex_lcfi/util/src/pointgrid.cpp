@@ -0,0 +1,82 @@
+#include "../inc/pointgrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vertex_lcfi { namespace util{
+
+	namespace
+	{
+		//Cells per axis, 21 bits of each coordinate go in the key
+		const std::int64_t NumCells = std::int64_t(1) << 21;
+	}
+
+	PointGrid::PointGrid(const std::vector<Vector3> & Points, double Radius)
+	: _Points(Points),_CellSize(Radius)
+	{
+		if (_Points.empty())
+			return;
+		Vector3 Lower = _Points.front();
+		Vector3 Upper = _Points.front();
+		for (std::vector<Vector3>::const_iterator iPoint = _Points.begin();iPoint != _Points.end();++iPoint)
+		{
+			Lower.x() = std::min(Lower.x(),iPoint->x());
+			Lower.y() = std::min(Lower.y(),iPoint->y());
+			Lower.z() = std::min(Lower.z(),iPoint->z());
+			Upper.x() = std::max(Upper.x(),iPoint->x());
+			Upper.y() = std::max(Upper.y(),iPoint->y());
+			Upper.z() = std::max(Upper.z(),iPoint->z());
+		}
+		_Origin = Lower;
+		//Cells big enough that every point has coordinates that fit in the key
+		const double Extent = std::max(Upper.x()-Lower.x(),std::max(Upper.y()-Lower.y(),Upper.z()-Lower.z()));
+		_CellSize = std::max(_CellSize,Extent/double(NumCells-1));
+		if (!(_CellSize > 0.0))
+			_CellSize = 1.0;
+
+		_Cells.reserve(_Points.size());
+		for (std::size_t Index = 0;Index < _Points.size();++Index)
+		{
+			std::int64_t i,j,k;
+			this->_cellOf(_Points[Index],i,j,k);
+			_Cells.push_back(std::make_pair(this->_cellKey(i,j,k),Index));
+		}
+		std::sort(_Cells.begin(),_Cells.end());
+	}
+
+	void PointGrid::_cellOf(const Vector3 & Position, std::int64_t & i, std::int64_t & j, std::int64_t & k) const
+	{
+		i = std::int64_t(std::floor((Position.x()-_Origin.x())/_CellSize));
+		j = std::int64_t(std::floor((Position.y()-_Origin.y())/_CellSize));
+		k = std::int64_t(std::floor((Position.z()-_Origin.z())/_CellSize));
+	}
+
+	std::uint64_t PointGrid::_cellKey(std::int64_t i, std::int64_t j, std::int64_t k) const
+	{
+		return (std::uint64_t(i) << 42) | (std::uint64_t(j) << 21) | std::uint64_t(k);
+	}
+
+	void PointGrid::pointsWithin(const Vector3 & Position, double Radius, std::vector<std::size_t> & Indices) const
+	{
+		Indices.clear();
+		if (_Points.empty())
+			return;
+		std::int64_t i,j,k;
+		this->_cellOf(Position,i,j,k);
+		const double Radius2 = Radius*Radius;
+		for (std::int64_t di = -1;di <= 1;++di)
+		for (std::int64_t dj = -1;dj <= 1;++dj)
+		for (std::int64_t dk = -1;dk <= 1;++dk)
+		{
+			//Cells off the grid hold no points
+			if (i+di < 0 || i+di >= NumCells || j+dj < 0 || j+dj >= NumCells || k+dk < 0 || k+dk >= NumCells)
+				continue;
+			const std::uint64_t Key = this->_cellKey(i+di,j+dj,k+dk);
+			std::vector<std::pair<std::uint64_t,std::size_t> >::const_iterator iCell =
+				std::lower_bound(_Cells.begin(),_Cells.end(),std::make_pair(Key,std::size_t(0)));
+			for (;iCell != _Cells.end() && iCell->first == Key;++iCell)
+				if (_Points[iCell->second].distanceTo2(Position) <= Radius2)
+					Indices.push_back(iCell->second);
+		}
+		std::sort(Indices.begin(),Indices.end());
+	}
+}}
@@ -0,0 +1,132 @@
+#include "../inc/taskpool.h"
+#include <algorithm>
+
+namespace vertex_lcfi { namespace util{
+
+	TaskPool::TaskPool(unsigned int NumThreads)
+	: _Ranges(NumThreads ? NumThreads : std::max(1u,std::thread::hardware_concurrency()))
+	{
+		for (unsigned int Worker = 1; Worker < _Ranges.size(); ++Worker)
+			_Threads.push_back(std::thread(&TaskPool::_loop,this,Worker));
+	}
+
+	TaskPool::~TaskPool()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(_Mutex);
+			_Stop = true;
+		}
+		_Start.notify_all();
+		for (std::vector<std::thread>::iterator iThread = _Threads.begin();iThread != _Threads.end();++iThread)
+			iThread->join();
+	}
+
+	void TaskPool::run(std::size_t NumTasks, const Task & Function)
+	{
+		const std::size_t NumWorkers = _Ranges.size();
+		if (NumWorkers == 1 || NumTasks == 1)
+		{
+			for (std::size_t iTask = 0; iTask < NumTasks; ++iTask)
+				Function(iTask,0);
+			return;
+		}
+		if (NumTasks == 0)
+			return;
+
+		for (std::size_t Worker = 0; Worker < NumWorkers; ++Worker)
+		{
+			std::lock_guard<std::mutex> Lock(_Ranges[Worker].Mutex);
+			_Ranges[Worker].Begin = NumTasks*Worker/NumWorkers;
+			_Ranges[Worker].End = NumTasks*(Worker+1)/NumWorkers;
+		}
+		{
+			std::lock_guard<std::mutex> Lock(_Mutex);
+			_Function = &Function;
+			_Busy = unsigned(NumWorkers-1);
+			++_Generation;
+		}
+		_Start.notify_all();
+		this->_work(0);
+		std::unique_lock<std::mutex> Lock(_Mutex);
+		_Done.wait(Lock,[this]{return _Busy == 0;});
+		_Function = nullptr;
+	}
+
+	void TaskPool::_loop(unsigned int Worker)
+	{
+		unsigned long Generation = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> Lock(_Mutex);
+				_Start.wait(Lock,[this,Generation]{return _Stop || _Generation != Generation;});
+				if (_Stop)
+					return;
+				Generation = _Generation;
+			}
+			this->_work(Worker);
+			{
+				std::lock_guard<std::mutex> Lock(_Mutex);
+				if (--_Busy == 0)
+					_Done.notify_all();
+			}
+		}
+	}
+
+	void TaskPool::_work(unsigned int Worker)
+	{
+		std::size_t Task;
+		while (this->_next(Worker,Task))
+			(*_Function)(Task,Worker);
+	}
+
+	bool TaskPool::_next(unsigned int Worker, std::size_t & Task)
+	{
+		Range & Own = _Ranges[Worker];
+		{
+			std::lock_guard<std::mutex> Lock(Own.Mutex);
+			if (Own.Begin < Own.End)
+			{
+				Task = Own.Begin++;
+				return true;
+			}
+		}
+		//Own range empty, steal the back half of the largest one left
+		for (;;)
+		{
+			std::size_t Victim = Worker;
+			std::size_t Largest = 0;
+			for (std::size_t Other = 0; Other < _Ranges.size(); ++Other)
+			{
+				if (Other == Worker)
+					continue;
+				std::lock_guard<std::mutex> Lock(_Ranges[Other].Mutex);
+				const std::size_t Size = _Ranges[Other].End - _Ranges[Other].Begin;
+				if (Size > Largest)
+				{
+					Largest = Size;
+					Victim = Other;
+				}
+			}
+			if (Largest == 0)
+				return false;
+
+			std::size_t Begin,End;
+			{
+				std::lock_guard<std::mutex> Lock(_Ranges[Victim].Mutex);
+				Range & From = _Ranges[Victim];
+				//Emptied since we looked, look again
+				if (From.Begin >= From.End)
+					continue;
+				End = From.End;
+				Begin = End - (End-From.Begin+1)/2;
+				From.End = Begin;
+			}
+			Task = Begin;
+			std::lock_guard<std::mutex> Lock(Own.Mutex);
+			Own.Begin = Begin+1;
+			Own.End = End;
+			return true;
+		}
+	}
+}}
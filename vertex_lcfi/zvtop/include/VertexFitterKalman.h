@@ -45,6 +45,39 @@ namespace vertex_lcfi
                      Matrix3x3 & ResultError, 
                      double & ChiSquaredOfFit);
 
+      void fitVertex(const std::vector<TrackState*> & Tracks, 
+                     InteractionPoint* IP, Vector3 & Result, 
+                     double & ChiSquaredOfFit, 
+                     std::vector<double> & ChiSquaredOfTrack,
+                     double & ChiSquaredOfIP);
+      
+      void fitVertex(const std::vector<TrackState*> & Tracks, 
+                     InteractionPoint* IP, Vector3 & Result, 
+                     Matrix3x3 & ResultError, 
+                     double & ChiSquaredOfFit, 
+                     std::vector<double> & ChiSquaredOfTrack,
+                     double & ChiSquaredOfIP);
+
+      //* Inverse Kalman update of the last fit: the measurement of Track, 
+      //  as added in the fit, is taken back out of the vertex position and 
+      //  its covariance, then the chi2 of the remaining tracks is recomputed. 
+      //  The linearisation of the other tracks is not redone, so after 
+      //  setFullRefitInterval() removals false is returned to have the 
+      //  caller fit again from scratch. Only the vertex position part of 
+      //  the state is updated.
+      
+      bool removeTrackFromFit(const std::vector<TrackState*> & Tracks, 
+                              InteractionPoint* IP, TrackState* Track, 
+                              Vector3 & Result, Matrix3x3 & ResultError, 
+                              double & ChiSquaredOfFit, 
+                              std::vector<double> & ChiSquaredOfTrack,
+                              double & ChiSquaredOfIP);
+
+      //* Removals allowed between full fits, 0 to always refit
+      
+      void   setFullRefitInterval(int Interval) { fFullRefitInterval = Interval; }
+      int    fullRefitInterval() const { return fFullRefitInterval; }
+
       double getDeviationFromVertex( const TState* state, const double v[], 
                                      const double Cv[] ) const;
       
@@ -58,6 +91,16 @@ namespace vertex_lcfi
 
       std::vector<TState> fStates{};
       std::vector<double> fChi2chain{};
+
+      //* Last fit, kept for removeTrackFromFit
+      
+      std::vector<TrackState*> fTracks{};       // as given to fitVertex
+      InteractionPoint*        fIP=nullptr;
+      std::vector<int>         fOrder{};        // index in fTracks of each of fStates
+      std::vector<double>      fMeasurements{}; // m[0..2], mV[0..5] of each of fStates at its update
+      bool        fFitIsFiltered=false;        // false unless the Kalman filter made the last fit
+      int         fNumRemoved=0;
+      int         fFullRefitInterval=10;
       
       Vector3     m_manualSeed{};
       bool        m_useManualSeed=false;
@@ -69,6 +112,10 @@ namespace vertex_lcfi
       int         fNDF=0;
       int         fQ=0; // to be kept? vertex charge?
       double      fChi2=0.0;
+
+      void   storeFit( InteractionPoint* IP, Vector3 & Result, 
+                       Matrix3x3 & ResultError, double & ChiSquaredOfFit );
+      void   fillChi2OfTracks( std::vector<double> & ChiSquaredOfTrack ) const;
           
     };    
   }  
@@ -3,6 +3,7 @@
 
 #include "../../util/inc/vector3.h"
 #include "../../util/inc/matrix.h"
+#include "../../util/inc/indexset.h"
 #include <vector>
 #include <list>
 #include <map>
@@ -24,6 +25,7 @@ namespace ZVTOP
 	class VertexResolver;
 	class VertexFuncMaxFinder;
 	class VertexFunction;
+	class VertexFitCache;
 	
 	class VertexFitterLSM;
 	class VertexResolverEqualSteps;
@@ -44,6 +46,11 @@ so that a fit only occurs if the track content changed <i>and</i> the fit is nee
 The vertex function maximum works in a similar way, except it is not currently invalidated on a change of
 track content as classic ZVTOP does not require this.
 <br>
+The trackstates are held in a vector with the chi squared of each from the last fit in a vector alongside it.
+Trackstates that have a table index (see TrackState::tableIndex()) are also marked in a bitset, so that asking
+whether a vertex has a track, or whether two vertices share any, does not search the track lists. Trackstates in
+one vertex should have their indices from the same table; while a vertex holds any without an index the lists are searched.
+<br>
 The per-instance algorithms can be overridden as the functions that use them are overloaded with a 
 version that takes a pointer to the algorithm class. For example calling isResolvedFrom(Vertex, Threshold, Resolver)
 rather than isResolvedFrom(Vertex,Threshold).
@@ -103,7 +110,7 @@ and then position().
 		\param Position Position of the fitted vertex
 		\param PositionError ErrorMatrix of the fitted vertex
 		\param ChiSquaredOfFit Chi Squared of total fit
-		\param ChiSquaredOfTrack A std::map of track chi squareds indexed by trackstate pointer
+		\param ChiSquaredOfTrack A std::map of track chi squareds indexed by trackstate pointer, its keys are taken as the trackstates of the vertex
 		\param ChiSquaredOfIP Chi squared contribution of IP object (if any)
 		*/
 		CandidateVertex(const Vector3 & Position, const Matrix3x3 & PositionError, double ChiSquaredOfFit, std::map<TrackState*,double> ChiSquaredOfTrack, double ChiSquaredOfIP);
@@ -144,6 +151,15 @@ and then position().
 		\return 1 if a track was removed; 0 otherwise.
 		*/
 		bool removeTrack(Track* const TrackToRemove);
+
+		//! Remove the first TrackState from this vertices track list which has the same parent track as TrackState
+		/*!
+		As removeTrack(State->parentTrack()) but if State has a table index that this vertex does not hold
+		it returns without searching the track list.
+		\param State Pointer to a TrackState of the track to remove.
+		\return 1 if a track was removed; 0 otherwise.
+		*/
+		bool removeTrackOf(const TrackState* const State);
 		
 		//! Add a TrackState to this vertex
 		/*!
@@ -166,6 +182,41 @@ and then position().
 		*/
 		void setIP(InteractionPoint* IP);
 		
+		//! Set the VertexFuncMaxFinder
+		/*!
+		Replaces the max finder given at construction. Any vertex function maximum already found is invalidated.
+		\param MaxFinder Pointer to the VertexFuncMaxFinder to use.
+		*/
+		void setMaxFinder(VertexFuncMaxFinder* MaxFinder);
+
+		//! Set the VertexResolver used by isResolvedFrom
+		void setResolver(VertexResolver* Resolver);
+
+		//! Share fits with other vertices of the same jet
+		/*!
+		refit() looks the trackstates, IP and fitter up in the cache before fitting and stores the fits it makes.
+		Vertices made by merging take the cache of the first vertex merged that has one.
+		\param Cache Cache to use, 0 for none.
+		*/
+		void setFitCache(VertexFitCache* Cache);
+
+		//! Take a fit of this vertex made elsewhere
+		/*!
+		Stores the result of fitting the trackstates and IP of this vertex, for example on another thread,
+		as if refit() had been called. The error of the fit is left invalid.
+		\param Position Fitted position.
+		\param ChiSquaredOfFit Total chi squared.
+		\param ChiSquaredOfTrack Chi squared of each trackstate, in the order of trackStateList().
+		\param ChiSquaredOfIP Chi squared of the IP, 0 if none.
+		*/
+		void setFit(const Vector3 & Position, double ChiSquaredOfFit, const std::vector<double> & ChiSquaredOfTrack, double ChiSquaredOfIP);
+
+		//! Take a vertex function maximum found elsewhere
+		/*!
+		Stores the position and value of the maximum as if findVertexFuncMax() had been called.
+		*/
+		void setVertexFuncMax(const Vector3 & Position, double Value);
+		
 		//! Merge another vertex into this one
 		/*!
 		Adds all the trackstates and the IP if held from SourceVertex to this vertices trackstate list, after removing any trackstates
@@ -189,6 +240,7 @@ and then position().
 		/*!
 		Using the fitter of this vertex (specified at constuction or default) the trackstate with the highest chi squared
 		is removed if it is below threshold. If one was removed then refit and check again, repeating until we have reached thresold.
+		Where the fitter can remove a track from its last fit (see VertexFitter::removeTrackFromFit()) that replaces the refit.
 		\param ProbThreshold Threshold for removal.
 		\return Number of trackstates removed.
 		*/
@@ -198,7 +250,7 @@ and then position().
 		/*!
 		Using the fitter of this vertex (specified at constuction or default) the trackstate with the highest chi squared
 		is removed if it is above threshold. If one was removed then refit and check again, repeating until threshold is reached
-		or we only have one track left..
+		or we only have one track left.. Where the fitter can remove a track from its last fit that replaces the refit.
 		Does not effect the IP held by this vertex if any.
 		\param Chi2Threshold Threshold for removal.
 		\return Number of trackstates removed.
@@ -209,6 +261,7 @@ and then position().
 		/*!
 		Using the fitter specified, the trackstate with the highest chi squared is removed if it is above 
 		threshold. If one was removed then refit and check again, repeating until one is not removed.
+		Where the fitter can remove a track from its last fit that replaces the refit.
 		Does not effect the IP held by this vertex if any.
 		\param Chi2Threshold Threshold for removal.
 		\param Fitter VertexFitter to use
@@ -282,6 +335,13 @@ and then position().
 		\return true if this vertex has a trackstate with this Track as parent
 		*/
 		bool hasTrack(Track* Track) const;
+
+		//!Return if this Vertex contains a trackstate of the same track as the one passed
+		/*!If the trackstate has a table index this is a single bit test.
+		\param State Pointer to a trackstate of the query track
+		\return true if this vertex has a trackstate with the same parent track
+		*/
+		bool hasTrackOf(const TrackState* State) const;
 		
 		//!Return the InteractionPoint in this Vertex.
 		/*!
@@ -347,7 +407,7 @@ and then position().
     		
 		//!Return the chi squared contribution of all the trackstates in this vertex.
 		/*!Note this may cause the vertex to be fit if needed.
-		\return A std::map of chi squared vlaues with TrackState pointers as the key
+		\return A std::map of chi squared vlaues with TrackState pointers as the key, made from the fit when first asked for
 		*/
 		const std::map<TrackState*, double> & chiSquaredOfAllTracks() const;
 		
@@ -365,22 +425,37 @@ and then position().
 
 	private:
 		
-		//Fallback Algo Classes
-		static VertexFitter* _FallbackFitter;
-		static VertexResolver* _FallbackResolver;
-		static VertexFuncMaxFinder* _FallbackMaxFinder;
+		//Fallback Algo Classes, one instance per thread
 		static VertexFitter* _getFallbackFitter();
 		static VertexResolver* _getFallbackResolver();
 		static VertexFuncMaxFinder* _getFallbackMaxFinder();
+
+		//Bookkeeping of the track table bits as trackstates come and go
+		void _indexTrackStates();
+		void _addTrackStateIndex(const TrackState* Track);
+		void _eraseTrackState(std::vector<TrackState*>::iterator Position);
+		//Remove the trackstates of the tracks in Tracks, only when the table stands for every trackstate
+		void _eraseTrackStatesIn(const IndexSet & Tracks);
+		//Whether the bits say for certain that no trackstate of Track is held
+		bool _certainlyLacks(const TrackState* Track) const;
+		//Position in the list of the trackstate with the highest chi squared, -1 if none
+		int _highestChiSquaredTrack() const;
+		//Remove a trimmed trackstate, taking it out of the fit with Fitter if it can, true if the fit is still valid
+		bool _trimTrackState(int Index, VertexFitter* Fitter);
 			
 		VertexFitter*	     _Fitter=nullptr;
 		VertexResolver*		 _Resolver=nullptr;
 		VertexFuncMaxFinder* _MaxFinder=nullptr;
+		VertexFitCache*      _FitCache=nullptr;
 		
 
 		//Tracks and IP
 		InteractionPoint* _IP=nullptr;
 		std::vector<vertex_lcfi::TrackState*> _TrackStates{};
+		//Table indices of the trackstates, and how many the table does not stand for, those
+		//with no index and any second trackstate of an indexed track
+		IndexSet _TrackTable{};
+		int _NumUnindexed=0;
 
 		//Vertex Function
 		VertexFunction*      _VertexFunction=nullptr;
@@ -392,7 +467,10 @@ and then position().
 		mutable Vector3 _Position{};
 		mutable Matrix3x3 _PositionError{};
 		mutable double _ChiSquaredOfFit=0.0;
-		mutable std::map<vertex_lcfi::TrackState*,double> _ChiSquaredOfTrack{};
+		//In the order of _TrackStates
+		mutable std::vector<double> _ChiSquaredOfTrack{};
+		mutable std::map<vertex_lcfi::TrackState*,double> _ChiSquaredOfTrackMap{};
+		mutable bool _ChiSquaredOfTrackMapIsValid=false;
 		mutable double _ChiSquaredOfIP=0.0;
 		mutable bool _FitIsValid=false;
 		mutable bool _ErrorOfFitIsValid=false;
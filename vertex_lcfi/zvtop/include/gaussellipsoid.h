@@ -5,6 +5,7 @@
 #include "../include/vertexfunctionelement.h"
 
 #include "../../util/inc/vector3.h"
+#include "../../util/inc/matrix.h"
 
 using namespace vertex_lcfi::util;
 
@@ -49,6 +50,15 @@ covariance matrix. (Both in x,y,z space)
 		*/
 		double valueAt(const Vector3 & Point) const;
 
+		//!Calculate the value of the ellipsoid at a point with its spatial derivatives
+		/*!
+		\param Point Vector3 of the spatial point
+		\param Gradient Set to the gradient of the ellipsoid at point
+		\param Hessian If not 0 set to the matrix of second derivatives of the ellipsoid at point
+		\return Value of ellipsoid at point, as valueAt
+		*/
+		double valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 * Hessian) const;
+
 		//!InteractionPoint object used
 		/*!
 		\return Pointer to InteractionPoint used by this instance
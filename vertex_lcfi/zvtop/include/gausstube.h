@@ -2,6 +2,7 @@
 #define GAUSSTUBE_H
 
 #include "../../util/inc/vector3.h"
+#include "../../util/inc/matrix.h"
 #include "../include/vertexfunctionelement.h"
 
 namespace vertex_lcfi
@@ -23,7 +24,9 @@ and V is the covariance matrix of the track. (Both in rPhi,z space)
 <br>Note this is a deliberatly unnormalised gaussian.
 <br>The Track is not modified at any point by this class
 <br>This guassian tube makes its own trackstate object from the track given 
-at construction which it uses to perform the calculation.
+at construction which it uses to perform the calculation. The overloads taking a
+TrackState swim that instead, leaving the tube unchanged, so that a tube can be
+evaluated from several threads each with its own TrackState.
 \author Ben Jeffery (b.jeffery1@physics.ox.ac.uk)
  \version 0.1
  \date    20/09/05
@@ -52,7 +55,67 @@ at construction which it uses to perform the calculation.
 		\return Value of tube at point
 		*/
 		double valueAt(const Vector3 & Point) const;
+		
+		//!Calculate the value of the tube at point, swimming Scratch
+		/*!
+		\param Point Vector3 of the spacial point
+		\param Scratch TrackState from makeScratch() to swim to the point of closest approach
+		\return Value of tube at point
+		*/
+		double valueAt(const Vector3 & Point, TrackState & Scratch) const;
+		
+		//!Residuals of point from the track, swimming Scratch
+		/*!
+		\param Point Vector3 of the spacial point
+		\param Scratch TrackState from makeScratch() to swim to the point of closest approach
+		\param RPhi Set to the XY distance to the track
+		\param Z Set to the residual along z
+		*/
+		void residual(const Vector3 & Point, TrackState & Scratch, double & RPhi, double & Z) const;
+		
+		//!Inverse of the (rPhi,z) position covariance of the track
+		inline const SymMatrix2x2 & inversePositionCovarMatrix() const
+		{return _InversePositionCovarMatrix;}
+		
+		//!Calculate the value of the tube at point with its spatial derivatives, swimming Scratch
+		/*!
+		The derivatives of the distances to the track come from the points of closest approach
+		(the envelope theorem) with the curvature of the helix included in the second derivatives.
+		\param Point Vector3 of the spacial point
+		\param Scratch TrackState from makeScratch() to swim to the point of closest approach
+		\param Gradient Set to the gradient of the tube at point
+		\param Hessian If not 0 set to the matrix of second derivatives of the tube at point
+		\return Value of tube at point, as valueAt
+		*/
+		double valueAt(const Vector3 & Point, TrackState & Scratch, Vector3 & Gradient, SymMatrix3x3 * Hessian) const;
+		
+		//!Lower bound on the chi squared of the tube at point, without swimming
+		/*!
+		Uses the XY distance from the point to the track's circle (or line if neutral), which
+		is never more than the RPhi residual. Minimising the tube's quadratic form over the Z
+		residual then bounds the chi squared, so valueAt(Point) <= exp(-0.5*bound).
+		\param Point Vector3 of the spacial point
+		\return Lower bound on the chi squared that valueAt would exponentiate
+		*/
+		double chiSquaredLowerBound(const Vector3 & Point) const;
+		
+		//!TrackState of the tube's track for use as scratch by valueAt
+		TrackState makeScratch() const;
 	private:
+		Track* _Track=nullptr;
+		//Fixed by the track so worked out once
+		SymMatrix2x2 _InversePositionCovarMatrix{};
+		double _SecLambda=1.0;
+		double _InvR=0.0;
+		//For chiSquaredLowerBound, the XY circle of the track (or its line if neutral)
+		//and the chi squared per unit XY distance squared
+		double _CentreX=0.0;
+		double _CentreY=0.0;
+		double _AbsRadius=0.0;
+		double _D0=0.0;
+		double _SinPhi=0.0;
+		double _CosPhi=1.0;
+		double _XYChi2Scale=0.0;
 		TrackState* _TrackState=nullptr;
 	};
 }
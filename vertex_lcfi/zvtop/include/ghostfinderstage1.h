@@ -51,6 +51,7 @@ and ignores the position of the Interaction Point. This should be fixed in a fut
 		//method that gives a value for chi2 at a point, this specific name
 		//is used so that the function minimiser template can be used.
 		double valueAt(std::vector<double> CurrentAngles);
+		void valuesAt(const std::vector<std::vector<double> > & Angles, std::vector<double> & Values);
 
 	private:
 		Track _makeGhost(std::vector<double> Angles, double Width);
@@ -13,7 +13,9 @@ namespace ZVTOP
 	//Class designed to be used on the chi2 function, but could really be used on any
 	//arbitary function, although it does use ZVTOP specifics (e.g. Vector3).
 	//Only prerequisite is that <T> has a method "double valueAt( Vector3 )" that returns
-	//the value of the function (be it the chi2 or whatever) at the point given
+	//the value of the function (be it the chi2 or whatever) at the point given, and a method
+	//"void valuesAt( const std::vector<std::vector<double> > &, std::vector<double> & )" that does the
+	//same for a series of points (the points of each numerical derivative are passed together)
 	template <class T>
 	class FunctionMinimiser
 	{
@@ -26,7 +28,8 @@ namespace ZVTOP
 	protected:
 		//Method that finds a vector that 'points down hill' by examining the rate of
 		//change of the function at the point "point".
-		std::vector<double> _findChangeRateVector( std::vector<double> point, double delta );
+		//Also gives the value at the point, so it needn't be evaluated again.
+		std::vector<double> _findChangeRateVector( std::vector<double> point, double delta, double & valueAtPoint );
 	
 		T* _pFunc;
 		double _initialDelta=0.0;//The offset that the change in the function is examined at (plus and minus).
@@ -64,7 +67,8 @@ namespace ZVTOP
 			{
 				iterations++;
 				//Find down hill vector, then make it the size of the current step
-				jacobian = _findChangeRateVector( inspectionPoint, currentDelta );
+				double valueAtInspectionPoint;
+				jacobian = _findChangeRateVector( inspectionPoint, currentDelta, valueAtInspectionPoint );
 				//Make length of current step and add to current point
 				for (std::vector<double>::iterator iJacobian = jacobian.begin();iJacobian < jacobian.end();++iJacobian)
 				{
@@ -83,7 +87,7 @@ namespace ZVTOP
 				//if (inspectionPoint.size()==2) std::cout << iterations << " " << _pFunc->valueAt(jacobian) << std::endl;
 				//If the step we are going to take takes us uphill then we have found a minimum so break the inner loop and go to higher precision
 				//std::cout.flush();
-					if (_pFunc->valueAt(inspectionPoint)<_pFunc->valueAt(jacobian))
+					if (valueAtInspectionPoint<_pFunc->valueAt(jacobian))
 						break;
 				//TODO should make step smaller here	
 					
@@ -130,17 +134,19 @@ namespace ZVTOP
 	}
 
 	template <class T>
-	std::vector<double> FunctionMinimiser<T>::_findChangeRateVector(std::vector<double> point, double delta)
+	std::vector<double> FunctionMinimiser<T>::_findChangeRateVector(std::vector<double> point, double delta, double & valueAtPoint)
 	{
-		double valueAtPoint=_pFunc->valueAt( point );
+		valueAtPoint=_pFunc->valueAt( point );
 		delta = (fabs(valueAtPoint)+1.0)*0.000001;
+		//Displace each coordinate in turn and evaluate them all together
+		std::vector<std::vector<double> > displaced(point.size(),point);
+		for (unsigned int i = 0;i < point.size();++i)
+			displaced[i][i] += delta;
+		std::vector<double> values;
+		_pFunc->valuesAt(displaced,values);
 		std::vector<double> jacobian;
-		for (std::vector<double>::iterator iPoint = point.begin();iPoint < point.end();++iPoint)
-		{
-			(*iPoint) += delta;
-			jacobian.push_back((_pFunc->valueAt(point)-valueAtPoint)/delta);
-			(*iPoint) -= delta;
-		}
+		for (unsigned int i = 0;i < point.size();++i)
+			jacobian.push_back((values[i]-valueAtPoint)/delta);
 		return jacobian;
 	
 	}
@@ -155,6 +161,7 @@ namespace ZVTOP
 		~FunctionMaximiser(){};//I doubt this will be derived from but stick it in anyway
 		std::vector<double> Maximise(std::vector<double> seedPoint );
 		double valueAt(std::vector<double> point );
+		void valuesAt(const std::vector<std::vector<double> > & points, std::vector<double> & values );
 	protected:
 		//Method that finds a vector that 'points down hill' by examining the rate of
 		//change of the function at the point "point".
@@ -183,6 +190,14 @@ namespace ZVTOP
 		return -(_pFunc->valueAt( point ));
 	}
 
+	template <class T>
+	void FunctionMaximiser<T>::valuesAt(const std::vector<std::vector<double> > & points, std::vector<double> & values )
+	{
+		_pFunc->valuesAt( points, values );
+		for (std::vector<double>::iterator iValue = values.begin();iValue < values.end();++iValue)
+			(*iValue) = -(*iValue);
+	}
+
 } //namespace
 }
 #endif //DIRECTIONFINDER_H
@@ -3,13 +3,19 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include "../../util/inc/vector3.h"
+#include "vertexfunction.h"
+#include "vertexfuncmaxfinder.h"
+#include "vertexresolver.h"
+#include "vertexfunctioncache.h"
 
 using namespace vertex_lcfi::util;
 
 namespace vertex_lcfi
 {
 	class Track;
+	class TrackState;
 //! Namespace containing ZVTOP Implementation
 namespace ZVTOP
 {
@@ -17,6 +23,7 @@ namespace ZVTOP
 	class CandidateVertex;
 	class InteractionPoint;
 	class VertexFunction;
+	class VertexFitCache;
 	
 //!Vertex Finding object - classic ZVTOP
 /*!
@@ -33,7 +40,7 @@ Note new mwmory management
 	public:
 		
 		//Constructors NB remember algoritm parameters are set per vertexfinder
-		VertexFinderClassic(const std::vector<Track*> &Tracks,InteractionPoint* IP, const Vector3 &JetAxis, double Kip = 1.0, double Kalpha = 5.0, double TwoProngCut = 10.0, double TrackTrimCut = 10.0, double ResolverCutOff = 0.6);
+		VertexFinderClassic(const std::vector<Track*> &Tracks,InteractionPoint* IP, const Vector3 &JetAxis, double Kip = 1.0, double Kalpha = 5.0, double TwoProngCut = 10.0, double TrackTrimCut = 10.0, double ResolverCutOff = 0.6, VertexFunctionPrecision Precision = DoublePrecision, VertexFuncMaxFinderType MaxFinderType = ClassicStepperMaxFinder, double TubeCullEpsilon = 0.0, double CacheGridSize = -1.0);
 
 		VertexFinderClassic(const vertex_lcfi::ZVTOP::VertexFinderClassic&) = delete;
 		VertexFinderClassic& operator=(const vertex_lcfi::ZVTOP::VertexFinderClassic&) = delete;
@@ -45,16 +52,66 @@ Note new mwmory management
 		bool removeTrack(Track* const Track);
 		bool clearIP();
 
+		//!Choose how candidate vertices are resolved from each other
+		/*!
+		\param Type EqualStepsResolver, the default, or BisectionResolver
+		\param NumSteps Number of steps along the line between the vertices, BisectionResolver only
+		\param Refinements Number of refinements about the lowest step, BisectionResolver only
+		*/
+		void setResolver(VertexResolverType Type, int NumSteps = 10, int Refinements = 0);
+
+		//!Take candidate vertices further apart than Radius as resolved without asking the resolver
+		/*!
+		Between vertices a few hundred microns apart the vertex function almost always falls
+		well below the resolver cut, as few tracks run close enough to each other all the way.
+		Beyond Radius pairs are resolved on distance alone, the distance between nearest maxima
+		when clustering or fitted positions when tracks are removed from unresolved candidates.
+		The maxima are binned on a grid of this size so only pairs within it are looked at.
+		<br>This trades accuracy for speed. On generated b jets radii of 1 mm or less changed
+		the track groupings of some jets, 0.2 mm those of about one in twenty, while the time
+		saved was within the run to run spread.
+		\param Radius Distance in mm, 0 or less to test every pair with the resolver
+		*/
+		void setResolverRadius(double Radius);
+
+		//!Make and fit the 2-prong candidates and find their maxima on several threads
+		/*!
+		Each candidate is fitted from fresh copies of its trackstates and the vertex function
+		is evaluated through a scratch per thread, so the result does not depend on the number
+		of threads or the order the candidates are worked on. With a CacheGridSize of 0 or more
+		each thread has a vertex function cache of its own for the findVertices() call, so with
+		a grid of 0 the result is as the serial code's, with a larger grid values may depend on
+		which thread evaluated a nearby point first.
+		\param NumThreads Number of threads, 1 for the serial code, 0 for one per hardware thread
+		*/
+		void setNumThreads(unsigned int NumThreads);
+
+		//!Share fits between the candidate vertices of a jet
+		/*!
+		Candidates that are refit with the same tracks, as happens after clustering and trimming,
+		take the fit from a VertexFitCache made for each findVertices() call. Hits and misses go to
+		VertexFitCache::cacheStatistics() when the event's objects are deleted.
+		\param Enable Whether to cache fits, off by default
+		*/
+		void setFitCache(bool Enable);
+
 		//run ZVRES!
 		std::list<CandidateVertex*> findVertices();
 
 	private:
 		std::vector<CandidateVertex*> _removeOneTrackNoIPVertices(std::list<CandidateVertex*>* CVList);
 		void _ifNoIPAddIP(std::list<CandidateVertex*>* CVList);
+		void _makeTwoProngsInParallel(const std::vector<TrackState*> & TrackStates, std::list<CandidateVertex*>* CVList);
+		void _findVertexFuncMaxInParallel(const std::list<CandidateVertex*> & CVList);
+		std::vector<std::vector<std::size_t> > _unresolvedPairs(const std::vector<CandidateVertex*> & Candidates) const;
+		VertexFunctionCache* _workerCache(unsigned int Worker) const;
 
 		std::vector<Track*> _TrackList{};
 		InteractionPoint* _IP=nullptr;
 		VertexFunction* _VF=nullptr;
+		VertexFuncMaxFinder* _MaxFinder=nullptr;
+		VertexResolver* _Resolver=nullptr;
+		VertexFuncMaxFinderType _MaxFinderType=ClassicStepperMaxFinder;
 		
 		double _Kip=0.0;
 		double _Kalpha=0.0;
@@ -62,6 +119,17 @@ Note new mwmory management
 		double _TwoProngCut=0.0;
 		double _TrackTrimCut=0.0;
 		double _ResolverCutOff=0.0;
+		VertexFunctionPrecision _Precision=DoublePrecision;
+		double _TubeCullEpsilon=0.0;
+		double _CacheGridSize=-1.0;
+		VertexResolverType _ResolverType=EqualStepsResolver;
+		int _ResolverSteps=10;
+		int _ResolverRefinements=0;
+		unsigned int _NumThreads=1;
+		double _ResolverRadius=0.0;
+		bool _UseFitCache=false;
+		VertexFitCache* _FitCache=nullptr;
+		std::vector<std::unique_ptr<VertexFunctionCache> > _WorkerCaches{};
 		
 	};
 }
@@ -43,6 +43,9 @@ Perform the ghost track algorithm on a set of tracks
         	double &initialGhostWidth() {return _InitialGhostWidth;}
         	double maxChi2Allowed() const {return _MaxChi2Allowed;}
         	double &maxChi2Allowed() {return _MaxChi2Allowed;}
+		//!Whether candidates share their fits through a VertexFitCache, as trial merges often refit the same tracks
+        	bool useFitCache() const {return _UseFitCache;}
+        	bool &useFitCache() {return _UseFitCache;}
         	
 		// returns true if track was in set and removed
 		bool removeTrack(Track* const Track);
@@ -58,6 +61,7 @@ Perform the ghost track algorithm on a set of tracks
 		double _MinimumProbability=0.0;
 		double _InitialGhostWidth=0.0;
 		double _MaxChi2Allowed=0.0;
+		bool _UseFitCache=false;
 		
 		std::vector<Track*> _TrackList{};
 		InteractionPoint* _IP=nullptr;
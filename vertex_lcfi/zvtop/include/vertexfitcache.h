@@ -0,0 +1,116 @@
+#ifndef VERTEXFITCACHE_H
+#define VERTEXFITCACHE_H
+
+#include "../../util/inc/vector3.h"
+#include "../../util/inc/matrix.h"
+#include <vector>
+#include <map>
+#include <cstddef>
+
+using namespace vertex_lcfi::util;
+
+namespace vertex_lcfi
+{
+	class TrackState;
+
+namespace ZVTOP
+{
+	class InteractionPoint;
+	class VertexFitter;
+
+	//!Lookups of the fit caches that have been destroyed
+	struct FitCacheStatistics
+	{
+		unsigned long Hits;
+		unsigned long Misses;
+	};
+
+//!Memo of vertex fits keyed on the tracks fitted
+/*!
+Maps the trackstates fitted, the IP and the fitter to the result of the fit, so that a
+CandidateVertex whose tracks come back to a list that has already been fitted, by merging,
+claiming or trimming, takes the earlier fit rather than fitting again.
+<br>The tracks are named by their table indices (see TrackState::tableIndex()), which must all
+come from one table, i.e. a cache belongs to one jet. Track lists with a trackstate without an
+index are neither looked up nor stored.
+<br>The indices are kept in the order of the track list rather than sorted, as VertexFitterLSM
+seeds from the tracks pairwise in list order and a 2-track fit is its seed, so the same tracks in
+another order can fit tens of microns away. Keyed on the order a hit is the fit that would have been made.
+<br>Not thread safe, a cache belongs to whoever fits through it.
+*/
+	class VertexFitCache
+	{
+	public:
+		VertexFitCache() = default;
+		//!Adds the hits and misses to the statistics of this thread
+		~VertexFitCache();
+		VertexFitCache(const VertexFitCache&) = delete;
+		VertexFitCache& operator=(const VertexFitCache&) = delete;
+
+		//!Look up a fit
+		/*!
+		\param Tracks Trackstates fitted
+		\param IP InteractionPoint fitted, 0 if none
+		\param Fitter Fitter used
+		\param NeedError Only take a fit that has its position error
+		\param Position Set to the fitted position on a hit
+		\param PositionError Set to the error of the fit on a hit if NeedError
+		\param ChiSquaredOfFit Set to the total chi squared on a hit
+		\param ChiSquaredOfTrack Set to the chi squared of each track, in the order of Tracks, on a hit
+		\param ChiSquaredOfIP Set to the chi squared of the IP on a hit
+		\return true on a hit
+		*/
+		bool find(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, VertexFitter* Fitter, bool NeedError, Vector3 & Position, Matrix3x3 & PositionError, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack, double & ChiSquaredOfIP);
+
+		//!Store a fit, replacing any held for the same tracks
+		/*!
+		Arguments as find(), with PositionError 0 if the error was not calculated.
+		*/
+		void insert(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, VertexFitter* Fitter, const Vector3 & Position, const Matrix3x3 * PositionError, double ChiSquaredOfFit, const std::vector<double> & ChiSquaredOfTrack, double ChiSquaredOfIP);
+
+		//!Number of fits held
+		inline std::size_t size() const
+		{return _Fits.size();}
+
+		//!Number of lookups that found a fit
+		inline unsigned long hits() const
+		{return _Hits;}
+
+		//!Number of lookups that did not
+		inline unsigned long misses() const
+		{return _Misses;}
+
+		//!Hits and misses of the caches destroyed by this thread
+		static const FitCacheStatistics & cacheStatistics();
+		//!Clear the cache statistics of this thread
+		static void resetCacheStatistics();
+
+	private:
+		struct Key
+		{
+			std::vector<int> Tracks;
+			const InteractionPoint* IP;
+			const VertexFitter* Fitter;
+			bool operator<(const Key & Other) const;
+		};
+		struct Fit
+		{
+			Vector3 Position;
+			Matrix3x3 PositionError;
+			bool ErrorIsValid;
+			double ChiSquaredOfFit;
+			std::vector<double> ChiSquaredOfTrack;
+			double ChiSquaredOfIP;
+		};
+
+		//Fills Result, false if the tracks cannot be cached
+		static bool _key(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, VertexFitter* Fitter, Key & Result);
+		static FitCacheStatistics & _cacheStatistics();
+
+		std::map<Key,Fit> _Fits{};
+		unsigned long _Hits=0;
+		unsigned long _Misses=0;
+	};
+}
+}
+#endif //VERTEXFITCACHE_H
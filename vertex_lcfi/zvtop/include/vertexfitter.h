@@ -4,6 +4,7 @@
 #include "../../util/inc/vector3.h"
 #include "../../util/inc/matrix.h"
 #include <vector>
+#include <map>
 
 using namespace vertex_lcfi::util;
 
@@ -32,7 +33,51 @@ Pure virtual class interface class, cannot be instantiated.
 		virtual void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, double & ChiSquaredOfFit) = 0;
 		virtual void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, double & ChiSquaredOfFit, std::map<TrackState*,double> & ChiSquaredOfTrack,double & ChiSquaredOfIP) = 0;
 		virtual void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, Matrix3x3 & ResultError, double & ChiSquaredOfFit, std::map<TrackState*,double> & ChiSquaredOfTrack,double & ChiSquaredOfIP) = 0;
+		//!As the std::map versions with the chi squared of each track in the order of Tracks
+		/*!
+		These fit with the std::map versions and copy the values out, fitters that can fill
+		the vector directly should override them to save building the map.
+		*/
+		virtual void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack,double & ChiSquaredOfIP)
+		{
+			std::map<TrackState*,double> ChiSquaredOfTrackMap;
+			this->fitVertex(Tracks,IP,Result,ChiSquaredOfFit,ChiSquaredOfTrackMap,ChiSquaredOfIP);
+			_copyChiSquareds(Tracks,ChiSquaredOfTrackMap,ChiSquaredOfTrack);
+		}
+		virtual void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, Matrix3x3 & ResultError, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack,double & ChiSquaredOfIP)
+		{
+			std::map<TrackState*,double> ChiSquaredOfTrackMap;
+			this->fitVertex(Tracks,IP,Result,ResultError,ChiSquaredOfFit,ChiSquaredOfTrackMap,ChiSquaredOfIP);
+			_copyChiSquareds(Tracks,ChiSquaredOfTrackMap,ChiSquaredOfTrack);
+		}
+		//!Take one track out of the last fit made instead of fitting the rest again
+		/*!
+		Fitters that can remove a track's contribution from a fit (e.g. by an inverse Kalman update)
+		override this, the others keep this version which never removes and so always leaves the caller to refit.
+		<br>Tracks and IP must be those of the last fit this fitter made, and the result is that of the fit of the
+		remaining tracks in the order of Tracks, as close to a refit as the fitter can make it.
+		\param Tracks Trackstates of the last fit, including Track
+		\param IP InteractionPoint of the last fit, 0 if none
+		\param Track Trackstate to remove
+		\param Result Set to the fitted position if removed
+		\param ResultError Set to the error of the fitted position if removed
+		\param ChiSquaredOfFit Set to the total chi squared if removed
+		\param ChiSquaredOfTrack Set to the chi squared of each remaining track if removed
+		\param ChiSquaredOfIP Set to the chi squared of the IP if removed
+		\return true if removed, false if the outputs are untouched and the remaining tracks must be fitted again
+		*/
+		virtual bool removeTrackFromFit(const std::vector<TrackState*> & /*Tracks*/, InteractionPoint* /*IP*/, TrackState* /*Track*/, Vector3 & /*Result*/, Matrix3x3 & /*ResultError*/, double & /*ChiSquaredOfFit*/, std::vector<double> & /*ChiSquaredOfTrack*/,double & /*ChiSquaredOfIP*/)
+		{
+			return false;
+		}
 		virtual ~VertexFitter() {}
+	private:
+		static void _copyChiSquareds(const std::vector<TrackState*> & Tracks, std::map<TrackState*,double> & From, std::vector<double> & To)
+		{
+			To.clear();
+			for (std::vector<TrackState*>::const_iterator iTrack = Tracks.begin();iTrack != Tracks.end();++iTrack)
+				To.push_back(From[*iTrack]);
+		}
 	};
 }
 }
@@ -30,10 +30,14 @@ namespace ZVTOP
 		void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, double & ChiSquaredOfFit);
 		void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, double & ChiSquaredOfFit, std::map<TrackState*,double> & ChiSquaredOfTrack,double & ChiSquaredOfIP);
 		void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, Matrix3x3 & ResultError, double & ChiSquaredOfFit, std::map<TrackState*,double> & ChiSquaredOfTrack,double & ChiSquaredOfIP);
+		void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack,double & ChiSquaredOfIP);
+		void fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, Matrix3x3 & ResultError, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack,double & ChiSquaredOfIP);
 		//method that gives a value for chi2 at a point, this specific name
 		//is used so that the function minimiser template can be used.
 		double valueAt( const Vector3 & point );
 		double valueAt( const std::vector<double> & point );
+		//values at a series of nearby points, as valueAt for each, sharing the track swims between them
+		void valuesAt( const std::vector<std::vector<double> > & points, std::vector<double> & values );
 		
 		void setSeed(Vector3 Seed);
 		void setInitialStep(double Step);
@@ -45,6 +49,7 @@ namespace ZVTOP
 		double _InitialStep=0.0;
 		double _chi2Contribution( const Vector3 & point, TrackState* pTrackState );//contribution from each individual track
 		double _chi2Contribution( const Vector3 & point, InteractionPoint* pIP );  //the contribution from the ip only (N.B. pIP could be NULL)
+		void _fitError( const std::vector<TrackState*> & Tracks, InteractionPoint* IP, const Vector3 & Result, Matrix3x3 & ResultError );
 	};
 }
 }
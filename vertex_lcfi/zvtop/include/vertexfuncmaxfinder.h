@@ -10,6 +10,18 @@ namespace vertex_lcfi
 namespace ZVTOP
 {
 	class VertexFunction;
+
+	//!Method used to find the nearest maximum of a vertex function
+	/*!
+	ClassicStepperMaxFinder is VertexFuncMaxFinderClassicStepper, axis by axis stepping as
+	the original SLD code. TrustRegionMaxFinder is VertexFuncMaxFinderTrustRegion, Newton
+	steps on the analytic derivatives.
+	*/
+	enum VertexFuncMaxFinderType
+	{
+		ClassicStepperMaxFinder,
+		TrustRegionMaxFinder
+	};
 	
 //!Vertex Function Maximum Finder Interface
 /*!
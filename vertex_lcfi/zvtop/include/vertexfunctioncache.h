@@ -0,0 +1,85 @@
+#ifndef VERTEXFUNCTIONCACHE_H
+#define VERTEXFUNCTIONCACHE_H
+
+#include "../../util/inc/vector3.h"
+#include <vector>
+#include <cstddef>
+
+using namespace vertex_lcfi::util;
+
+namespace vertex_lcfi
+{
+namespace ZVTOP
+{
+//!Memo of vertex function values keyed on position
+/*!
+Open addressing hash table, linear probing, from a point to the value of a
+VertexFunction there. Points are quantised to a cubic grid so that a point
+within the same cell as one already evaluated returns the stored value, with
+a grid size of 0 only bitwise identical points match. The table doubles when
+half full and is cleared once it reaches the maximum number of entries.
+<br>Not thread safe, a cache belongs to whoever evaluates through it.
+*/
+	class VertexFunctionCache
+	{
+	public:
+		//!Construct an empty cache
+		/*!
+		\param GridSize Side of the cells points are quantised to in mm, 0 for exact matching
+		\param MaxEntries Number of entries at which the cache is cleared
+		*/
+		explicit VertexFunctionCache(double GridSize = 0.0001, std::size_t MaxEntries = 1<<16);
+
+		//!Look up the value at Point
+		/*!
+		\param Point Point to look up
+		\param Value Set to the stored value on a hit
+		\return true on a hit
+		*/
+		bool find(const Vector3 & Point, double & Value);
+
+		//!Store the value at Point, which must not already be held
+		void insert(const Vector3 & Point, double Value);
+
+		//!Remove all entries, the counters are kept
+		void clear();
+
+		//!Side of the quantisation cells in mm
+		inline double gridSize() const
+		{return _GridSize;}
+
+		//!Number of entries held
+		inline std::size_t size() const
+		{return _Size;}
+
+		//!Number of lookups that found a value
+		inline unsigned long hits() const
+		{return _Hits;}
+
+		//!Number of lookups that did not
+		inline unsigned long misses() const
+		{return _Misses;}
+
+	private:
+		struct Entry
+		{
+			long long Key[3];
+			double Value;
+			bool Used;
+		};
+
+		void _key(const Vector3 & Point, long long* Key) const;
+		std::size_t _slot(const long long* Key) const;
+		void _grow();
+
+		double _GridSize=0.0;
+		double _InvGridSize=0.0;
+		std::size_t _MaxEntries=0;
+		std::size_t _Size=0;
+		unsigned long _Hits=0;
+		unsigned long _Misses=0;
+		std::vector<Entry> _Table{};
+	};
+}
+}
+#endif //VERTEXFUNCTIONCACHE_H
@@ -2,9 +2,11 @@
 #define VERTEXFUNCTIONCLASSIC_H
 
 #include "vertexfunction.h"
+#include "vertexfunctioncache.h"
 #include "../../util/inc/vector3.h"
 #include "../../util/inc/matrix.h"
 #include <vector>
+#include <cmath>
 
 namespace vertex_lcfi
 {
@@ -17,6 +19,29 @@ namespace ZVTOP
 	class GaussTube;
 	class GaussEllipsoid;
 
+	//!Deviations between single and double precision vertex function values
+	/*!
+	Accumulated by VertexFunctionClassic in ValidatePrecision mode by each thread
+	evaluating, and merged over the threads by VertexFunctionClassic::precisionValidation().
+	Relative deviations are only taken where the double value is above the 0.001
+	cut used on two-prong candidates, ThresholdDisagreements counts evaluations
+	where the two precisions fall on different sides of that cut.
+	*/
+	struct PrecisionValidation
+	{
+		unsigned long Evaluations;
+		unsigned long ThresholdDisagreements;
+		double MaxAbsDeviation;
+		double MaxRelDeviation;
+	};
+
+	//!Lookups of the value caches of vertex functions that have been destroyed
+	struct CacheStatistics
+	{
+		unsigned long Hits;
+		unsigned long Misses;
+	};
+
 //!VertexFunction as in ZVTOP paper
 /*!
 Function that implements:
@@ -34,10 +59,13 @@ V(\mathbf{r})\rightarrow V(\mathbf{r})exp(-K_{\alpha}\alpha^2)
 \f] 
 Where \f$ \alpha\f$ is the angle between JetAxis and \f$ \mathbf{r}\f$. \f$ K_{IP}\f$ is then just a weight on the Jet Axis.
 
-\todo Derivative functions not yet implemented.
+The derivatives are analytic, from those of each GaussTube and the GaussEllipsoid and of the
+\f$ K_{\alpha}\f$ factor, and are taken in double precision whatever precision() is.
 
 This class constucts GaussTube and GaussEllipsoid objects and uses thier valueAt(Vector3 Point) to perform the evaluation,
 how the tubes are evaluated depends on them.
+<br>valueAt(Point) swims TrackStates held by the function, so is not safe to call from several threads.
+valueAt(Point,Scratch) swims the caller's scratch instead and can be, with one scratch per thread.
 
 Destruction cleans up all GaussTube and GaussEllipsoid objects created.
  \author Ben Jeffery (b.jeffery1@physics.ox.ac.uk)
@@ -61,10 +89,69 @@ Destruction cleans up all GaussTube and GaussEllipsoid objects created.
 		VertexFunctionClassic& operator=(const vertex_lcfi::ZVTOP::VertexFunctionClassic&) = delete;
 		//!Find the value of the vertex function at Point
 		double valueAt(const Vector3 & Point) const;
-		//!Find the spacial derivative of the vertex function at Point (not implemented)
-		Matrix3x3 firstDervAt(const Vector3 & Point) const;
-		//!Find the 2nd spacial derivative of the vertex function at Point (not implemented)
-		Matrix3x3 secondDervAt(const Vector3 & Point) const;
+		//!Find the value of the vertex function at Point, swimming the tracks in Scratch
+		double valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const;
+		//!Fill Scratch with a TrackState for each track
+		void makeScratch(VertexFunctionScratch & Scratch) const;
+		//!Find the gradient of the vertex function at Point
+		Vector3 firstDervAt(const Vector3 & Point) const;
+		//!Find the matrix of 2nd spacial derivatives of the vertex function at Point
+		SymMatrix3x3 secondDervAt(const Vector3 & Point) const;
+		//!Find the value and gradient of the vertex function at Point, sharing the track swims
+		double valueAt(const Vector3 & Point, Vector3 & Gradient) const;
+		//!Find the value and gradient of the vertex function at Point, swimming the tracks in Scratch
+		double valueAt(const Vector3 & Point, Vector3 & Gradient, VertexFunctionScratch & Scratch) const;
+		//!Find the value, gradient and 2nd derivatives of the vertex function at Point, swimming the tracks in Scratch
+		double valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 & Hessian, VertexFunctionScratch & Scratch) const;
+		
+		//!Set the arithmetic used by valueAt, DoublePrecision by default
+		void setPrecision(VertexFunctionPrecision Precision);
+		//!Arithmetic used by valueAt
+		VertexFunctionPrecision precision() const;
+		
+		//!Set the tube value below which tubes are left out of the sums, 0 (the default) for none
+		/*!
+		Before a tube is swum to the point its value is bounded by GaussTube::chiSquaredLowerBound,
+		which needs only the XY distance to the track's circle. Tubes bounded below Epsilon are
+		skipped, so each is in error by less than Epsilon and far tubes cost a few multiplications.
+		The bound is still worked out for every tube, culling does not index the tubes by position.
+		With Epsilon 0 no bound is worked out and the sums cost what they did before.
+		\param Epsilon Largest tube value that may be left out
+		*/
+		void setCullEpsilon(double Epsilon);
+		//!Tube value below which tubes are left out of the sums
+		double cullEpsilon() const;
+		
+		//!Remember the values returned by valueAt(Point)
+		/*!
+		Points in the same cell of a grid of side GridSize as one already evaluated return
+		its value without evaluating, as do all repeats of a point if GridSize is 0. The
+		overloads taking a scratch use the scratch's cache instead, if it has one, so remain
+		safe to call from several threads each with its own scratch.
+		\param GridSize Side of the cells in mm
+		*/
+		void enableCache(double GridSize);
+		//!Stop caching and forget the values held
+		void disableCache();
+		//!Cache used by valueAt(Point), 0 if not enabled
+		const VertexFunctionCache* cache() const;
+		
+		//!Hits and misses of the caches of functions destroyed by this thread
+		static const CacheStatistics & cacheStatistics();
+		//!Add the lookups of a cache used through a scratch to the statistics of this thread
+		static void countCacheLookups(const VertexFunctionCache & Cache);
+		//!Clear the cache statistics of this thread
+		static void resetCacheStatistics();
+		
+		//!Deviations seen by all threads in ValidatePrecision mode
+		/*!
+		Merges the counts of the threads still running with those of the threads that have
+		finished, so must not be called while other threads are evaluating, e.g. call it at
+		the end of the run.
+		*/
+		static PrecisionValidation precisionValidation();
+		//!Clear the deviations seen by all threads, with the same restriction
+		static void resetPrecisionValidation();
 	
 	private:
 		//This is seperated his as later on we might want to take and add tracks willy-nilly so I
@@ -77,6 +164,20 @@ Destruction cleans up all GaussTube and GaussEllipsoid objects created.
 		double _Kip=0.0;
 		double _Kalpha=0.0;
 		Vector3 _JetAxis{};
+		VertexFunctionPrecision _Precision=DoublePrecision;
+		double _CullEpsilon=0.0;
+		//Tubes with a chi squared bound above this are skipped, -2ln(_CullEpsilon)
+		double _CullChiSquared=HUGE_VAL;
+		//Used by valueAt(Point)
+		mutable VertexFunctionScratch _Scratch{};
+		VertexFunctionCache* _Cache=nullptr;
+		
+		double _valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const;
+		double _valueAtDouble(const Vector3 & Point, VertexFunctionScratch & Scratch) const;
+		float _valueAtSingle(const Vector3 & Point, VertexFunctionScratch & Scratch) const;
+		double _derivativesAt(const Vector3 & Point, VertexFunctionScratch & Scratch, Vector3 & Gradient, SymMatrix3x3 * Hessian) const;
+		static PrecisionValidation & _validation();
+		static CacheStatistics & _cacheStatistics();
 		
 		double _sumOfTubes(const Vector3 & Point) const;
 		double _sumOfSquaredTubes(const Vector3 & Point) const;
@@ -25,7 +25,7 @@ V(\mathbf{r})= \sum_{i=0}^N f_i(\mathbf{r})-\frac{\sum_{i=0}^N f_i^2(\mathbf{r})
 \f] 
 for the Track and InteractionPoint objects given to it at construction.
 No Kip,Kalpha modifications.
-\todo Derivative functions not yet implemented.
+The derivatives are analytic, from those of each GaussTube and the GaussEllipsoid.
 
 This class constucts GaussTube and GaussEllipsoid objects and uses thier valueAt(Vector3 Point) to perform the evaluation,
 how the tubes are evaluated depends on them.
@@ -51,8 +51,12 @@ Destruction cleans up all GaussTube and GaussEllipsoid objects created.
 
 		//Query Methods
 		double valueAt(const Vector3 & Point) const;
-		Matrix3x3 firstDervAt(const Vector3 & Point) const;
-		Matrix3x3 secondDervAt(const Vector3 & Point) const;
+		double valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const;
+		void makeScratch(VertexFunctionScratch & Scratch) const;
+		Vector3 firstDervAt(const Vector3 & Point) const;
+		SymMatrix3x3 secondDervAt(const Vector3 & Point) const;
+		double valueAt(const Vector3 & Point, Vector3 & Gradient, VertexFunctionScratch & Scratch) const;
+		double valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 & Hessian, VertexFunctionScratch & Scratch) const;
 	
 	private:
 		//This is seperated his as later on we might want to take and add tracks willy-nilly so I
@@ -61,7 +65,10 @@ Destruction cleans up all GaussTube and GaussEllipsoid objects created.
 		std::vector<VertexFunctionElement*> _ElementsNewedByThis{};
 		std::vector<GaussTube*> _Tubes{};
 		GaussEllipsoid* _Ellipsoid=nullptr;
+		//Used by valueAt(Point)
+		mutable VertexFunctionScratch _Scratch{};
 		
+		double _derivativesAt(const Vector3 & Point, VertexFunctionScratch & Scratch, Vector3 & Gradient, SymMatrix3x3 * Hessian) const;
 		double _sumOfTubes(const Vector3 & Point) const;
 		double _sumOfSquaredTubes(const Vector3 & Point) const;
 	};
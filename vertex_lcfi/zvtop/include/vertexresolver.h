@@ -12,6 +12,18 @@ namespace ZVTOP
 	//Forward Declarations
 	class VertexFunction;
 
+	//!Method used to decide if two vertices are resolved
+	/*!
+	EqualStepsResolver is VertexResolverEqualSteps, samples in order along the line as the
+	original SLD code. BisectionResolver is VertexResolverBisection, the same samples from
+	the midpoint outwards with optional refinement about the lowest.
+	*/
+	enum VertexResolverType
+	{
+		EqualStepsResolver,
+		BisectionResolver
+	};
+
 //!Vertex Resolver Interface
 /*!
 Pure virtual class interface class, cannot be instantiated.
@@ -23,6 +35,13 @@ Pure virtual class interface class, cannot be instantiated.
 	{
 	public:
 		virtual bool areResolved(const Vector3& Vertex1, const Vector3& Vertex2, VertexFunction const * VertexFunction, const double Threshold) const = 0;
+		//!Resolve with the vertex function values at the two points already known
+		/*!
+		Value1 and Value2 must be the values VertexFunction returns at Vertex1 and Vertex2,
+		resolvers that need them override this to avoid evaluating them again.
+		*/
+		virtual bool areResolved(const Vector3& Vertex1, const Vector3& Vertex2, double /*Value1*/, double /*Value2*/, VertexFunction const * VertexFunction, const double Threshold) const
+		{return this->areResolved(Vertex1,Vertex2,VertexFunction,Threshold);}
 		virtual ~VertexResolver() {}
 	};
 }
@@ -0,0 +1,54 @@
+#ifndef VERTEXRESOLVERBISECTION_H
+#define VERTEXRESOLVERBISECTION_H
+
+#include "../../util/inc/vector3.h"
+#include "vertexresolver.h"
+#include <vector>
+
+using namespace vertex_lcfi::util;
+
+namespace vertex_lcfi
+{
+namespace ZVTOP
+{
+	//Forward Declarations
+	class VertexFunction;
+
+//!VertexResolver sampling from the midpoint outwards
+/*!
+Uses the same criterion as VertexResolverEqualSteps, the two points are resolved if the
+VertexFunction anywhere between them falls below Threshold times the lower of its values
+at the two points. The line is divided into NumSteps equal steps as there, but the points
+are sampled by repeated bisection, the midpoint first, then the midpoints of the two halves
+and so on, returning as soon as one falls below. Between two maxima the minimum is most
+often near the middle, so resolved pairs are usually found in one or two evaluations,
+and with the default 10 steps and no refinement the answer is always the same as
+VertexResolverEqualSteps.
+<br>If no sample falls below, each refinement evaluates the points half a step either side
+of the lowest sample so far and moves to the lowest, halving the step, which finds
+minima narrower than the step at two evaluations each.
+<br>Values at the two points passed to areResolved are used rather than evaluated again.
+*/
+	class VertexResolverBisection :
+		public VertexResolver
+	{
+	public:
+		//!Construct with the sampling settings
+		/*!
+		\param NumSteps Number of equal steps the line is divided into, at least 2
+		\param Refinements Number of refinements about the lowest sample if none is below threshold
+		*/
+		VertexResolverBisection(int NumSteps = 10, int Refinements = 0);
+		bool areResolved(const Vector3& Vertex1, const Vector3& Vertex2, VertexFunction const * VertexFunction, const double Threshold) const;
+		bool areResolved(const Vector3& Vertex1, const Vector3& Vertex2, double Value1, double Value2, VertexFunction const * VertexFunction, const double Threshold) const;
+
+	private:
+		int _NumSteps=0;
+		int _Refinements=0;
+		//Indices of the interior sample points in the order they are evaluated
+		std::vector<int> _SampleOrder{};
+	};
+}
+}
+
+#endif //VERTEXRESOLVERBISECTION_H
@@ -30,6 +30,7 @@ The number of sample points is currently hard-wired.
 	public:
 		VertexResolverEqualSteps();
 		bool areResolved(const Vector3& Vertex1, const Vector3& Vertex2, VertexFunction const * VertexFunction, const double Threshold) const;
+		bool areResolved(const Vector3& Vertex1, const Vector3& Vertex2, double Value1, double Value2, VertexFunction const * VertexFunction, const double Threshold) const;
 	};
 }
 }
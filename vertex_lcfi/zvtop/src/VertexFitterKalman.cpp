@@ -12,6 +12,7 @@
 */
 
 #include <map>
+#include <algorithm>
 #include "../include/VertexFitterKalman.h"
 #include "../include/interactionpoint.h"
 #include "../include/vertexfitterlsm.h"
@@ -43,9 +44,13 @@ namespace vertex_lcfi { namespace ZVTOP {
     for( int i=0; i<21; ++i) fC[i] = 0.;
     fC[0] = fC[2] = fC[5] = 10000.;
     
-    double chi2sum = 0;    
     int    maxIter = 3;
 
+    fTracks = Tracks;
+    fIP = IP;
+    fFitIsFiltered = false;
+    fNumRemoved = 0;
+
 
     //* Convert TrackStates to TStates
     
@@ -84,8 +89,19 @@ namespace vertex_lcfi { namespace ZVTOP {
     
 
     //* Sort track states according to transverse momentum
+    //  - through their indices, so the track each came from is kept
     
-    std::sort( fStates.begin(), fStates.end(), pDecreasing );    
+    fOrder.resize( fStates.size() );
+    for( unsigned int i=0; i<fOrder.size(); ++i ) fOrder[i] = i;
+    std::sort( fOrder.begin(), fOrder.end(), 
+               [this](int lhs, int rhs) { return pDecreasing( fStates[lhs], fStates[rhs] ); } );
+    {
+      std::vector<TState> sorted;
+      sorted.reserve( fStates.size() );
+      for( unsigned int i=0; i<fOrder.size(); ++i ) sorted.push_back( fStates[fOrder[i]] );
+      fStates.swap( sorted );
+    }
+    fMeasurements.resize( 9*fStates.size() );
 
 
     //* Set initial vertex position guess (for linearisation)
@@ -227,6 +243,12 @@ namespace vertex_lcfi { namespace ZVTOP {
         
         // last iteration -> update the particle
         
+        //* Keep the measurement for removeTrackFromFit
+        
+        double *fM = &fMeasurements[ 9*(it-fStates.begin()) ];
+        for( int i=0; i<3; ++i ) fM[i]   = m[i];
+        for( int i=0; i<6; ++i ) fM[3+i] = mV[i];
+        
         //* Add the daughter momentum to the particle momentum
         
         ffP[ 3] += m[ 3];
@@ -266,9 +288,21 @@ namespace vertex_lcfi { namespace ZVTOP {
     }
     
     
+    fFitIsFiltered = true;
+    
+    this->storeFit( IP, Result, ResultError, ChiSquaredOfFit );
+    
+  }
+  
+  
+  void VertexFitterKalman::storeFit(InteractionPoint* IP, 
+                                    Vector3 & Result, 
+                                    Matrix3x3 & ResultError, 
+                                    double & ChiSquaredOfFit) {
+    
     //* Recalculate Chi2 (although Kalman filter Chi2 is fine)      
     
-    chi2sum = 0;    
+    double chi2sum = 0;    
     fChi2chain.clear(); // for potential event re-weighting
     
     for( std::vector<TState>::iterator it = fStates.begin(); 
@@ -353,6 +387,149 @@ namespace vertex_lcfi { namespace ZVTOP {
     if( IP ) ChiSquaredOfIP = IP->chi2(Result);
 
   }  
+
+
+  void VertexFitterKalman::fitVertex(const std::vector<TrackState*> & Tracks, 
+                                     InteractionPoint* IP, 
+                                     Vector3 & Result, double & ChiSquaredOfFit, 
+                                     std::vector<double> & ChiSquaredOfTrack,
+                                     double & ChiSquaredOfIP) 
+  {		
+    Matrix3x3 ResultError;
+    this->fitVertex(Tracks, IP, Result, ResultError, ChiSquaredOfFit,
+                    ChiSquaredOfTrack, ChiSquaredOfIP);
+  }
+  
+
+  void VertexFitterKalman::fitVertex(const std::vector<TrackState*> & Tracks, 
+                                     InteractionPoint* IP, 
+                                     Vector3 & Result, Matrix3x3 & ResultError, 
+                                     double & ChiSquaredOfFit, 
+                                     std::vector<double> & ChiSquaredOfTrack,
+                                     double & ChiSquaredOfIP) {
+    
+    this->fitVertex(Tracks, IP, Result, ResultError, ChiSquaredOfFit);
+    
+    this->fillChi2OfTracks( ChiSquaredOfTrack );
+    
+    ChiSquaredOfIP = 0;    
+    if( IP ) ChiSquaredOfIP = IP->chi2(Result);
+
+  }  
+
+
+  void VertexFitterKalman::fillChi2OfTracks( std::vector<double> & ChiSquaredOfTrack ) const
+  {
+    //* The filter has the chi2 of each state already, in pT order
+    
+    ChiSquaredOfTrack.assign( fTracks.size(), 0. );
+    if( fFitIsFiltered ) 
+    {
+      for( unsigned int i=0; i<fOrder.size(); ++i ) 
+        ChiSquaredOfTrack[fOrder[i]] = fChi2chain[i];
+      return;
+    }
+    for( unsigned int i=0; i<fTracks.size(); ++i ) 
+    {
+      TState myState(fTracks[i]);      
+      ChiSquaredOfTrack[i] = getDeviationFromVertex( &myState, fP, fC );
+    }
+  }
+
+
+  bool VertexFitterKalman::removeTrackFromFit(const std::vector<TrackState*> & Tracks, 
+                                              InteractionPoint* IP, TrackState* Track, 
+                                              Vector3 & Result, Matrix3x3 & ResultError, 
+                                              double & ChiSquaredOfFit, 
+                                              std::vector<double> & ChiSquaredOfTrack,
+                                              double & ChiSquaredOfIP) {
+    
+    //* Only the last fit can be updated, and only if the filter made it
+    //           - fewer than two tracks left are fitted by LSM
+    
+    if( !fFitIsFiltered || fNumRemoved >= fFullRefitInterval ) return false;
+    if( Tracks.size() < 3 || IP != fIP || Tracks != fTracks ) return false;
+    
+    std::vector<TrackState*>::const_iterator its = std::find( Tracks.begin(), Tracks.end(), Track );
+    if( Tracks.end() == its ) return false;
+    int iTrack = its - Tracks.begin();
+    int iState = std::find( fOrder.begin(), fOrder.end(), iTrack ) - fOrder.begin();
+    
+    const double *m = &fMeasurements[9*iState], *mV = m+3;
+    
+    //* Inverse update is the update with the measurement covariance negated:
+    //  S = (C-V)^-1, r -= K*(r-m), C -= K*C' with K = C*S
+    
+    double mS[6];
+    {
+      double mSi[6] = { fC[0]-mV[0], 
+                        fC[1]-mV[1], fC[2]-mV[2], 
+                        fC[3]-mV[3], fC[4]-mV[4], fC[5]-mV[5] };
+      
+      mS[0] = mSi[2]*mSi[5] - mSi[4]*mSi[4];
+      mS[1] = mSi[3]*mSi[4] - mSi[1]*mSi[5];
+      mS[2] = mSi[0]*mSi[5] - mSi[3]*mSi[3];
+      mS[3] = mSi[1]*mSi[4] - mSi[2]*mSi[3];
+      mS[4] = mSi[1]*mSi[3] - mSi[0]*mSi[4];
+      mS[5] = mSi[0]*mSi[2] - mSi[1]*mSi[1];	 
+      
+      double s = ( mSi[0]*mS[0] + mSi[1]*mS[1] + mSi[3]*mS[3] );
+      if( fabs(s) < 1.E-20 ) return false;
+      s = 1./s;
+      
+      mS[0]*=s; mS[1]*=s; mS[2]*=s;
+      mS[3]*=s; mS[4]*=s; mS[5]*=s;
+    }
+    
+    double zeta[3] = { m[0]-fP[0], m[1]-fP[1], m[2]-fP[2] };    
+    
+    double mCHt0[3] = { fC[0], fC[1], fC[3] };
+    double mCHt1[3] = { fC[1], fC[2], fC[4] };
+    double mCHt2[3] = { fC[3], fC[4], fC[5] };
+    
+    double k0[3], k1[3], k2[3];
+    
+    for(int i=0;i<3;++i){
+      k0[i] = mCHt0[i]*mS[0] + mCHt1[i]*mS[1] + mCHt2[i]*mS[3];
+      k1[i] = mCHt0[i]*mS[1] + mCHt1[i]*mS[2] + mCHt2[i]*mS[4];
+      k2[i] = mCHt0[i]*mS[3] + mCHt1[i]*mS[4] + mCHt2[i]*mS[5];
+    }
+    
+    double P[3], C[6];
+    for( int i=0; i<3; ++i )
+      P[i] = fP[i] + k0[i]*zeta[0] + k1[i]*zeta[1] + k2[i]*zeta[2];
+    for(int i=0,k=0; i<3; ++i) {          
+      for(int j=0; j<=i; ++j,++k) 
+        C[k] = fC[k] - (k0[i]*mCHt0[j] + k1[i]*mCHt1[j] + k2[i]*mCHt2[j] );
+    }
+    
+    //* A track that was not measured better than the rest gives an
+    //  unphysical covariance - leave it to a full fit
+    
+    if( !(C[0] > 0. && C[2] > 0. && C[5] > 0.) ) return false;
+    
+    for( int i=0; i<3; ++i ) fP[i] = P[i];
+    for( int i=0; i<6; ++i ) fC[i] = C[i];
+    fNDF -= 2;
+    ++fNumRemoved;
+    
+    //* Forget the track
+    
+    fTracks.erase( fTracks.begin()+iTrack );
+    fStates.erase( fStates.begin()+iState );
+    fMeasurements.erase( fMeasurements.begin()+9*iState, fMeasurements.begin()+9*(iState+1) );
+    fOrder.erase( fOrder.begin()+iState );
+    for( unsigned int i=0; i<fOrder.size(); ++i ) 
+      if( fOrder[i] > iTrack ) --fOrder[i];
+    
+    this->storeFit( IP, Result, ResultError, ChiSquaredOfFit );
+    this->fillChi2OfTracks( ChiSquaredOfTrack );
+    
+    ChiSquaredOfIP = 0;    
+    if( IP ) ChiSquaredOfIP = IP->chi2(Result);
+    
+    return true;
+  }
   
   // -----------------------------------------------------------------------------------
   
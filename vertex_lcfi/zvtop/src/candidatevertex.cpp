@@ -3,6 +3,7 @@
 
 #include "../include/vertexfitter.h"
 #include "../include/vertexfitterlsm.h"
+#include "../include/vertexfitcache.h"
 #include "../include/vertexresolver.h"
 #include "../include/vertexresolverequalsteps.h"
 #include "../include/vertexfuncmaxfinder.h"
@@ -20,23 +21,30 @@ namespace vertex_lcfi
 {
 namespace ZVTOP
 {
-VertexFitter* CandidateVertex::_FallbackFitter;
-VertexResolver* CandidateVertex::_FallbackResolver;
-VertexFuncMaxFinder* CandidateVertex::_FallbackMaxFinder;
-
 //Construct from tracks and vertex function
 CandidateVertex::CandidateVertex(const std::vector<TrackState*>& Tracks, VertexFunction* VertexFunction, VertexFitter* Fitter, VertexResolver* Resolver, VertexFuncMaxFinder* MaxFinder)
         : _Fitter(Fitter),_Resolver(Resolver),_MaxFinder(MaxFinder),_IP(0),_TrackStates(Tracks),_VertexFunction(VertexFunction),_VertexFuncMaxIsValid(0),_FitIsValid(0),_ErrorOfFitIsValid(0)
-{/*NO OP*/}
+{
+	this->_indexTrackStates();
+}
 
 //Construct from tracks,ip and vertex function
 CandidateVertex::CandidateVertex(const std::vector<TrackState*>& Tracks, InteractionPoint* IP,VertexFunction* VertexFunction, VertexFitter* Fitter, VertexResolver* Resolver, VertexFuncMaxFinder* MaxFinder)
         : _Fitter(Fitter),_Resolver(Resolver),_MaxFinder(MaxFinder),_IP(IP),_TrackStates(Tracks),_VertexFunction(VertexFunction),_VertexFuncMaxIsValid(0),_FitIsValid(0),_ErrorOfFitIsValid(0)
-{/*NO OP*/}
+{
+	this->_indexTrackStates();
+}
 
 CandidateVertex::CandidateVertex(const Vector3 & Position, const Matrix3x3 & PositionError, double ChiSquaredOfFit, std::map<TrackState*,double> ChiSquaredOfTrack, double ChiSquaredOfIP)
-	:_Position(Position),_PositionError(PositionError),_ChiSquaredOfFit(ChiSquaredOfFit),_ChiSquaredOfTrack(ChiSquaredOfTrack),_ChiSquaredOfIP(ChiSquaredOfIP),_FitIsValid(1),_ErrorOfFitIsValid(1)
-{/*NO OP*/}
+	:_Position(Position),_PositionError(PositionError),_ChiSquaredOfFit(ChiSquaredOfFit),_ChiSquaredOfTrackMap(ChiSquaredOfTrack),_ChiSquaredOfTrackMapIsValid(1),_ChiSquaredOfIP(ChiSquaredOfIP),_FitIsValid(1),_ErrorOfFitIsValid(1)
+{
+	for (std::map<TrackState*,double>::const_iterator iTrack = ChiSquaredOfTrack.begin();iTrack != ChiSquaredOfTrack.end();++iTrack)
+	{
+		_TrackStates.push_back(iTrack->first);
+		_ChiSquaredOfTrack.push_back(iTrack->second);
+	}
+	this->_indexTrackStates();
+}
 
 CandidateVertex::CandidateVertex(const std::vector<CandidateVertex*> & Vertices, VertexFitter* Fitter, VertexResolver* Resolver, VertexFuncMaxFinder* MaxFinder)
 	: _Fitter(Fitter),_Resolver(Resolver),_MaxFinder(MaxFinder),_VertexFuncMaxIsValid(0),_FitIsValid(0),_ErrorOfFitIsValid(0)
@@ -48,10 +56,12 @@ CandidateVertex::CandidateVertex(const std::vector<CandidateVertex*> & Vertices,
 		//Get the tracks from all vertices
 		for (std::vector<CandidateVertex*>::const_iterator iCV = Vertices.begin();iCV != Vertices.end();++iCV)
 		{
+			if (!_FitCache)
+				_FitCache = (*iCV)->_FitCache;
 			for (std::vector<TrackState*>::const_iterator iTrack = (*iCV)->trackStateList().begin();iTrack != (*iCV)->trackStateList().end();++iTrack)
 			{
 				//Check we don't have the track already then add it
-				if (!this->hasTrack((*iTrack)->parentTrack()))
+				if (!this->hasTrackOf(*iTrack))
 				{
 					this->addTrackState(*iTrack);
 				}
@@ -65,11 +75,12 @@ CandidateVertex::CandidateVertex(const std::vector<CandidateVertex*> & Vertices,
 
 bool CandidateVertex::removeTrackState(TrackState* const TrackToRemove)
 {
+    if (this->_certainlyLacks(TrackToRemove))
+        return 0;
     std::vector<TrackState*>::iterator position = find(_TrackStates.begin(), _TrackStates.end(), TrackToRemove);
     if (position!=_TrackStates.end()) //Found
     {
-        _TrackStates.erase(position);
-        this->invalidateFit();
+        this->_eraseTrackState(position);
         return 1;
     }
     else
@@ -84,20 +95,102 @@ bool CandidateVertex::removeTrack(Track * const TrackToRemove)
     //iTrack now points to end or the track we want to remove
     if (iTrack!=_TrackStates.end())
     {
-        _TrackStates.erase(iTrack);
-        this->invalidateFit();
+        this->_eraseTrackState(iTrack);
         return 1;
     }
     else
         return 0;
 }
 
+bool CandidateVertex::removeTrackOf(const TrackState* const State)
+{
+    if (this->_certainlyLacks(State))
+        return 0;
+    return this->removeTrack(State->parentTrack());
+}
+
 void CandidateVertex::addTrackState(TrackState* TrackToAdd)
 {
     _TrackStates.push_back(TrackToAdd);
+    this->_addTrackStateIndex(TrackToAdd);
     this->invalidateFit();
 }
 
+void CandidateVertex::_indexTrackStates()
+{
+    _TrackTable.clear();
+    _NumUnindexed = 0;
+    for (std::vector<TrackState*>::const_iterator iTrack = _TrackStates.begin();iTrack != _TrackStates.end();++iTrack)
+        this->_addTrackStateIndex(*iTrack);
+}
+
+void CandidateVertex::_addTrackStateIndex(const TrackState* Track)
+{
+    if (Track->tableIndex() < 0 || _TrackTable.contains(Track->tableIndex()))
+        ++_NumUnindexed;
+    else
+        _TrackTable.insert(Track->tableIndex());
+}
+
+void CandidateVertex::_eraseTrackState(std::vector<TrackState*>::iterator Position)
+{
+    const int Index = (*Position)->tableIndex();
+    _TrackStates.erase(Position);
+    //With one trackstate to each bit its bit goes with it, otherwise count again
+    if (_NumUnindexed == 0)
+        _TrackTable.erase(Index);
+    else
+        this->_indexTrackStates();
+    this->invalidateFit();
+}
+
+void CandidateVertex::_eraseTrackStatesIn(const IndexSet & Tracks)
+{
+    std::vector<TrackState*>::iterator NewEnd = std::remove_if(_TrackStates.begin(),_TrackStates.end(),
+        [&Tracks](const TrackState* Track){return Tracks.contains(Track->tableIndex());});
+    if (NewEnd == _TrackStates.end())
+        return;
+    _TrackStates.erase(NewEnd,_TrackStates.end());
+    _TrackTable.erase(Tracks);
+    this->invalidateFit();
+}
+
+bool CandidateVertex::_certainlyLacks(const TrackState* Track) const
+{
+    return _NumUnindexed == 0 && Track->tableIndex() >= 0 && !_TrackTable.contains(Track->tableIndex());
+}
+
+int CandidateVertex::_highestChiSquaredTrack() const
+{
+    if (!_FitIsValid)
+        this->refit(); //TODO CHECK FIT OK
+    int HighTrack = -1;
+    double HighChiSquared = -1;
+    for (std::size_t iTrack = 0;iTrack < _ChiSquaredOfTrack.size();++iTrack)
+    {
+        if (_ChiSquaredOfTrack[iTrack] > HighChiSquared)
+        {
+            HighChiSquared = _ChiSquaredOfTrack[iTrack];
+            HighTrack = int(iTrack);
+        }
+    }
+    return HighTrack;
+}
+
+bool CandidateVertex::_trimTrackState(int Index, VertexFitter* Fitter)
+{
+    //The fitter checks that its last fit was of these trackstates, the fit is left as it was if not
+    const bool Removed = _FitIsValid && Fitter->removeTrackFromFit(_TrackStates,_IP,_TrackStates[Index],_Position,_PositionError,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP);
+    this->_eraseTrackState(_TrackStates.begin()+Index);
+    if (Removed)
+    {
+        //Not stored in the fit cache, which holds full fits
+        _FitIsValid=1;
+        _ErrorOfFitIsValid=1;
+    }
+    return Removed;
+}
+
 
 bool CandidateVertex::removeIP()
 {
@@ -117,6 +210,42 @@ void CandidateVertex::setIP(InteractionPoint* IP)
     this->invalidateFit();
 }
 
+void CandidateVertex::setMaxFinder(VertexFuncMaxFinder* MaxFinder)
+{
+    _MaxFinder=MaxFinder;
+    _VertexFuncMaxIsValid=0;
+}
+
+void CandidateVertex::setResolver(VertexResolver* Resolver)
+{
+    _Resolver=Resolver;
+}
+
+void CandidateVertex::setFitCache(VertexFitCache* Cache)
+{
+    _FitCache=Cache;
+}
+
+void CandidateVertex::setFit(const Vector3 & Position, double ChiSquaredOfFit, const std::vector<double> & ChiSquaredOfTrack, double ChiSquaredOfIP)
+{
+    _Position=Position;
+    _ChiSquaredOfFit=ChiSquaredOfFit;
+    _ChiSquaredOfTrack=ChiSquaredOfTrack;
+    _ChiSquaredOfTrackMapIsValid=0;
+    _ChiSquaredOfIP=ChiSquaredOfIP;
+    _FitIsValid=1;
+    _ErrorOfFitIsValid=0;
+    if (_FitCache)
+        _FitCache->insert(_TrackStates,_IP,_Fitter,_Position,0,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP);
+}
+
+void CandidateVertex::setVertexFuncMax(const Vector3 & Position, double Value)
+{
+    _VertexFuncMaxPosition=Position;
+    _VertexFuncMaxValue=Value;
+    _VertexFuncMaxIsValid=1;
+}
+
 void CandidateVertex::mergeCandidateVertex(const CandidateVertex* SourceVertex)
 {
     //Check which func max is biggest and keep it.
@@ -131,9 +260,23 @@ void CandidateVertex::mergeCandidateVertex(const CandidateVertex* SourceVertex)
 			this->setIP(SourceVertex->interactionPoint());
 	
 	std::vector<TrackState*> SourceList = SourceVertex->trackStateList();
+	if (_NumUnindexed == 0 && SourceVertex->_NumUnindexed == 0)
+	{
+		//Ours of the tracks both have make way for the source's, found from the shared bits
+		const IndexSet Shared = _TrackTable.intersection(SourceVertex->_TrackTable);
+		if (!Shared.empty())
+			this->_eraseTrackStatesIn(Shared);
+		if (!SourceList.empty())
+		{
+			_TrackStates.insert(_TrackStates.end(),SourceList.begin(),SourceList.end());
+			_TrackTable.insert(SourceVertex->_TrackTable);
+			this->invalidateFit();
+		}
+		return;
+	}
     for (std::vector<TrackState*>::iterator iSourceTrack = SourceList.begin();iSourceTrack != SourceList.end();++iSourceTrack)
     {
-        this->removeTrack((*iSourceTrack)->parentTrack());	//Removing before we add ensures no duplicates.
+        this->removeTrackOf(*iSourceTrack);	//Removing before we add ensures no duplicates.
         this->addTrackState(*iSourceTrack);
     }
 }
@@ -146,10 +289,17 @@ void CandidateVertex::claimTracksFrom(const std::list<CandidateVertex*> & Losing
         //Only one IP so if we have it they can't
 		if (_IP)
 			(*iLosingVertex)->removeIP();
+		//The tables say which tracks we share
+		if (_NumUnindexed == 0 && (*iLosingVertex)->_NumUnindexed == 0)
+		{
+			if (_TrackTable.intersects((*iLosingVertex)->_TrackTable))
+				(*iLosingVertex)->_eraseTrackStatesIn(_TrackTable.intersection((*iLosingVertex)->_TrackTable));
+			continue;
+		}
 		//Loop over my tracks, messaging to remove from losing vertex
         for (std::vector<TrackState*>::iterator iTrackState = _TrackStates.begin();iTrackState != _TrackStates.end();++iTrackState)
         {
-            (*iLosingVertex)->removeTrack((*iTrackState)->parentTrack());
+            (*iLosingVertex)->removeTrackOf(*iTrackState);
         }
     }
 }
@@ -166,19 +316,10 @@ int CandidateVertex::trimByProb(const double ProbThreshold)
 	if (Prob < ProbThreshold)
         {
 		//Find Track with Highest Chi Squared
-		TrackState* HighTrack = 0;
-		double HighChiSquared = -1;
-		for (std::vector<TrackState*>::iterator iTrackState = _TrackStates.begin();iTrackState != _TrackStates.end();++iTrackState)
-		{
-		    if (this->chiSquaredOfTrack(*iTrackState) > HighChiSquared)   //Refit happens when chiSquaredOfTrackChecks
-		    {
-			HighChiSquared = this->chiSquaredOfTrack(*iTrackState);
-			HighTrack = *iTrackState;
-		    }
-		}
-		//std::cout << HighChiSquared << std::endl;
+		const int HighTrack = this->_highestChiSquaredTrack();
 		//std::cout << this->trackStateList().size() << std::endl;
-		this->removeTrackState(HighTrack);
+		if (HighTrack >= 0)
+			this->_trimTrackState(HighTrack,_Fitter);
 		++NumRemoved;
 	}
         // Otherwise we are below threshold
@@ -204,27 +345,20 @@ int CandidateVertex::trimByChi2(const double Chi2Threshold)
     do
     {
         //Find Track with Highest Chi Squared
-        TrackState* HighTrack = 0;
-        double		HighChiSquared = -1;
-        for (std::vector<TrackState*>::iterator iTrackState = _TrackStates.begin();iTrackState != _TrackStates.end();++iTrackState)
-        {
-            if (this->chiSquaredOfTrack(*iTrackState) > HighChiSquared)   //Refit happens when chiSquaredOfTrackChecks
-            {
-                HighChiSquared = this->chiSquaredOfTrack(*iTrackState);
-                HighTrack = *iTrackState;
-            }
-        }
+        const int HighTrack = this->_highestChiSquaredTrack();   //Refit happens here if needed
+        const double HighChiSquared = (HighTrack >= 0) ? _ChiSquaredOfTrack[HighTrack] : -1;
         //If this track is above threshold then remove it
         if (HighChiSquared > Chi2Threshold)
         {
-            this->removeTrackState(HighTrack);
+            if (HighTrack >= 0)
+                this->_trimTrackState(HighTrack,_Fitter);
             ++NumRemoved;
         }
         // Otherwise we found nothing above threshold so quit checking
         else
             break;
         //If we have no tracks left then also quit
-        if (HighTrack == 0)
+        if (HighTrack < 0)
             break;
     }
     while (1);
@@ -234,33 +368,27 @@ int CandidateVertex::trimByChi2(const double Chi2Threshold)
 int CandidateVertex::trimByChi2(const double Chi2Threshold, VertexFitter* Fitter)
 {
     int NumRemoved = 0;
+    bool FitIsFromFitter = 0;
     do
     {
         //Refit now to make sure we have a fit that used the fitter specified, other wise chiSquaredOfTrack will invoke default!
-        this->refit(Fitter); //TODO CHECK FIT OK
+        if (!FitIsFromFitter)
+            this->refit(Fitter); //TODO CHECK FIT OK
         //Find Track with Highest Chi Squared
-        //TODO This could be more fast/clever
-    	TrackState* HighTrack = 0;
-        double		HighChiSquared = -1;
-        for (std::vector<TrackState*>::iterator iTrackState = _TrackStates.begin();iTrackState != _TrackStates.end();++iTrackState)
-        {
-            if (this->chiSquaredOfTrack(*iTrackState) > HighChiSquared)
-            {
-                HighChiSquared = this->chiSquaredOfTrack(*iTrackState);
-                HighTrack = *iTrackState;
-            }
-        }
+        const int HighTrack = this->_highestChiSquaredTrack();
+        const double HighChiSquared = (HighTrack >= 0) ? _ChiSquaredOfTrack[HighTrack] : -1;
         //If this track is above threshold then remove it
         if (HighChiSquared > Chi2Threshold)
         {
-            this->removeTrackState(HighTrack);
+            if (HighTrack >= 0)
+                FitIsFromFitter = this->_trimTrackState(HighTrack,Fitter);
             ++NumRemoved;
         }
         // Otherwise we found nothing above so quit checking
         else
             break;
         //If we have no tracks left then also quit
-        if (HighTrack == 0)
+        if (HighTrack < 0)
             break;
     }
     while (1);
@@ -272,26 +400,26 @@ void CandidateVertex::invalidateFit() const
 {
     _FitIsValid=0;
     _ErrorOfFitIsValid=0;
+    _ChiSquaredOfTrackMapIsValid=0;
     //this->invalidateFuncMax(); //Taken out as we always keep the first max or one that is larger that it is replaced with when clustering
     //TODO Could make above optional on a per-vertex basis, but not currently needed.
 }
 
 void CandidateVertex::refit(bool CalculateError) const
 {
-	if (CalculateError) 
-	{
-		_Fitter->fitVertex(this->trackStateList(), this->interactionPoint(),_Position,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP);
-	}
-	else
-	{
-		_Fitter->fitVertex(this->trackStateList(), this->interactionPoint(),_Position,_PositionError,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP);
-	}
-	_FitIsValid=1;
-	_ErrorOfFitIsValid=CalculateError;
+	this->refit(_Fitter,CalculateError);
 }
 
 void CandidateVertex::refit(VertexFitter* Fitter,bool CalculateError) const
 {
+	//The branch below that fits the error is the one taken when CalculateError is not set, only a fit with the error will do for it
+	if (_FitCache && _FitCache->find(_TrackStates,_IP,Fitter,!CalculateError,_Position,_PositionError,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP))
+	{
+		_FitIsValid=1;
+		_ErrorOfFitIsValid=CalculateError;
+		_ChiSquaredOfTrackMapIsValid=0;
+		return;
+	}
     if (CalculateError) 
 	{
 		Fitter->fitVertex(this->trackStateList(), this->interactionPoint(),_Position,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP);
@@ -300,8 +428,11 @@ void CandidateVertex::refit(VertexFitter* Fitter,bool CalculateError) const
 	{
 		Fitter->fitVertex(this->trackStateList(), this->interactionPoint(),_Position,_PositionError,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP);
 	}
+	if (_FitCache)
+		_FitCache->insert(_TrackStates,_IP,Fitter,_Position,CalculateError ? 0 : &_PositionError,_ChiSquaredOfFit,_ChiSquaredOfTrack,_ChiSquaredOfIP);
 	_FitIsValid=1;
 	_ErrorOfFitIsValid=CalculateError;
+	_ChiSquaredOfTrackMapIsValid=0;
 }
 
 bool CandidateVertex::findVertexFuncMax() const
@@ -321,23 +452,24 @@ bool CandidateVertex::isResolvedFrom(CandidateVertex* const Vertex, const double
 			return _Resolver->areResolved(this->position(), Vertex->position(), _VertexFunction, Threshold);
 			break;
 		case NearestMaximum:
-			return _Resolver->areResolved(this->vertexFuncMaxPosition(), Vertex->vertexFuncMaxPosition(), _VertexFunction, Threshold);
+			//The values at the maxima are already known
+			return _Resolver->areResolved(this->vertexFuncMaxPosition(), Vertex->vertexFuncMaxPosition(), this->vertexFuncMaxValue(), Vertex->vertexFuncMaxValue(), _VertexFunction, Threshold);
 			break;
 	}
 	//TODO Throw as not supported
 	return 0;
 }
 
-bool CandidateVertex::isResolvedFrom(CandidateVertex* const Vertex, const double Threshold, CandidateVertex::eResolveType Type, VertexResolver* /*Resolver*/ ) const
+bool CandidateVertex::isResolvedFrom(CandidateVertex* const Vertex, const double Threshold, CandidateVertex::eResolveType Type, VertexResolver* Resolver ) const
 {
 	//Todo null vertex pointer check
 	switch (Type)
 	{
 		case FittedPosition:
-			return _Resolver->areResolved(this->position(), Vertex->position(), _VertexFunction, Threshold);
+			return Resolver->areResolved(this->position(), Vertex->position(), _VertexFunction, Threshold);
 			break;
 		case NearestMaximum:
-			return _Resolver->areResolved(this->vertexFuncMaxPosition(), Vertex->vertexFuncMaxPosition(), _VertexFunction, Threshold);
+			return Resolver->areResolved(this->vertexFuncMaxPosition(), Vertex->vertexFuncMaxPosition(), this->vertexFuncMaxValue(), Vertex->vertexFuncMaxValue(), _VertexFunction, Threshold);
 			break;
 	}
 	//TODO Throw as not supported
@@ -352,6 +484,13 @@ bool CandidateVertex::hasTrack(Track* Track) const
 	return 0;
 }
 
+bool CandidateVertex::hasTrackOf(const TrackState* State) const
+{
+	if (_NumUnindexed == 0 && State->tableIndex() >= 0)
+		return _TrackTable.contains(State->tableIndex());
+	return this->hasTrack(State->parentTrack());
+}
+
 const Vector3 & CandidateVertex::position() const
 {
 	if (!_FitIsValid)
@@ -404,14 +543,15 @@ const Vector3 & CandidateVertex::vertexFuncMaxPosition() const
 
 double CandidateVertex::chiSquaredOfTrack(TrackState* Track) const
 {
-    //TODO I'm pretty sure this can be done faster, as this is the paranoid way
 	if (!_FitIsValid)
         this->refit(); //TODO CHECK FIT OK
-	std::map<TrackState*,double>::iterator iTrack = _ChiSquaredOfTrack.find(Track);
-    if(iTrack == _ChiSquaredOfTrack.end())
+	if (this->_certainlyLacks(Track))
+		return -1;
+	std::vector<TrackState*>::const_iterator iTrack = find(_TrackStates.begin(), _TrackStates.end(), Track);
+    if(iTrack == _TrackStates.end())
         return -1;
     else
-        return _ChiSquaredOfTrack[Track];
+        return _ChiSquaredOfTrack[iTrack - _TrackStates.begin()];
 }
 
 double CandidateVertex::chiSquaredOfIP() const
@@ -431,7 +571,13 @@ const std::map<TrackState*, double> & CandidateVertex::chiSquaredOfAllTracks() c
   if (!_FitIsValid) {
     this->refit(); //TODO CHECK FIT OK
   }
-  return _ChiSquaredOfTrack;
+  if (!_ChiSquaredOfTrackMapIsValid) {
+    _ChiSquaredOfTrackMap.clear();
+    for (std::size_t iTrack = 0;iTrack < _TrackStates.size();++iTrack)
+      _ChiSquaredOfTrackMap.insert(std::pair<TrackState*,double>(_TrackStates[iTrack],_ChiSquaredOfTrack[iTrack]));
+    _ChiSquaredOfTrackMapIsValid = 1;
+  }
+  return _ChiSquaredOfTrackMap;
 }
 
 double CandidateVertex::chiSquaredOfFit() const
@@ -446,12 +592,11 @@ double CandidateVertex::maxChiSquaredOfTrackIP() const
 	if  (!_FitIsValid)
 		this->refit();
 	//Find Track with Highest Chi Squared
-	//TODO This could be more fast/clever
 	double HighChiSquared = 0;
-	for (std::vector<TrackState*>::const_iterator iTrackState = _TrackStates.begin();iTrackState != _TrackStates.end();++iTrackState)
+	for (std::vector<double>::const_iterator iChiSquared = _ChiSquaredOfTrack.begin();iChiSquared != _ChiSquaredOfTrack.end();++iChiSquared)
 	{
-		if (this->chiSquaredOfTrack(*iTrackState) > HighChiSquared)
-			HighChiSquared = this->chiSquaredOfTrack(*iTrackState);
+		if (*iChiSquared > HighChiSquared)
+			HighChiSquared = *iChiSquared;
 	}
 	//Check the IP too
 	if (_IP)
@@ -462,35 +607,23 @@ double CandidateVertex::maxChiSquaredOfTrackIP() const
 	return HighChiSquared;
 }
 
+//Fallbacks are per thread so that candidates can be made on worker threads
 VertexFitter* CandidateVertex::_getFallbackFitter()
 {
-    if (!_FallbackFitter)
-        {
-        	_FallbackFitter = new FallbackVertexFitter();
-        	MemoryManager<VertexFitter>::Run()->registerObject(_FallbackFitter);
-       	}
-        
-    return _FallbackFitter;
+    static thread_local FallbackVertexFitter Fitter;
+    return &Fitter;
 }
 
 VertexResolver* CandidateVertex::_getFallbackResolver()
 {
-    if (!_FallbackResolver)
-    {
-    	_FallbackResolver = new FallbackVertexResolver();
-       	MemoryManager<VertexResolver>::Run()->registerObject(_FallbackResolver);
-    }
-    return _FallbackResolver;
+    static thread_local FallbackVertexResolver Resolver;
+    return &Resolver;
 }
 
 VertexFuncMaxFinder* CandidateVertex::_getFallbackMaxFinder()
 {
-    if (!_FallbackMaxFinder)
-    {
-        _FallbackMaxFinder = new FallbackVertexFuncMaxFinder();
-       	MemoryManager<VertexFuncMaxFinder>::Run()->registerObject(_FallbackMaxFinder);
-    }
-    return _FallbackMaxFinder;
+    static thread_local FallbackVertexFuncMaxFinder MaxFinder;
+    return &MaxFinder;
 }
 }
 }
@@ -16,8 +16,29 @@ namespace vertex_lcfi { namespace ZVTOP
 		Vector3 RelativePoint = Point-(_IP->position());
 		//Calculate value of UNNORMALISED gaussian at point from covarience matrix
 		//Lyons pp 60
-		SymMatrix3x3 InvErr = _IP->inverseErrorMatrix();
-		return exp(-0.5 * prec_inner_prod(RelativePoint,prec_prod(InvErr, RelativePoint)));
+		return exp(-0.5 * quadraticForm(_IP->inverseErrorMatrix(), RelativePoint));
+	}
+
+	double GaussEllipsoid::valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 * Hessian) const
+	{
+		Vector3 RelativePoint = Point-(_IP->position());
+		const Matrix3x3 & M = _IP->inverseErrorMatrix();
+		const double Value = exp(-0.5 * quadraticForm(M, RelativePoint));
+		//For exp(-0.5r.M.r) the gradient is -value.M.r and the second derivative value.(M.r.r.M - M)
+		const double* m = &M.data()[0];
+		const Vector3 MR(m[0]*RelativePoint.x() + m[1]*RelativePoint.y() + m[2]*RelativePoint.z(),
+		                 m[3]*RelativePoint.x() + m[4]*RelativePoint.y() + m[5]*RelativePoint.z(),
+		                 m[6]*RelativePoint.x() + m[7]*RelativePoint.y() + m[8]*RelativePoint.z());
+		Gradient = MR*(-Value);
+		if (Hessian)
+		{
+			//M is symmetric, take its lower half
+			for (int i = 0; i < 3; ++i)
+				for (int j = 0; j <= i; ++j)
+					(*Hessian)(i,j) = -Value*M(i,j);
+			addOuterProduct(*Hessian, Value, MR);
+		}
+		return Value;
 	}
 
 	InteractionPoint* GaussEllipsoid::ip()
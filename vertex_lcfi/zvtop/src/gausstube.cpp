@@ -2,36 +2,179 @@
 #include "../../inc/trackstate.h"
 #include "../../inc/track.h"
 #include <math.h>
+#include <cmath>
+#include <algorithm>
 
 namespace vertex_lcfi { namespace ZVTOP
 {
   GaussTube::GaussTube(Track* Track):
+    _Track(Track),
     //We make a trackstate to be used by the tube, with the appropriate swimmer
     _TrackState( new TrackState(Track) )
-  {}
+  {
+    //The position covariance isn't propagated along the track so is the same at every point
+    _InversePositionCovarMatrix = _TrackState->inversePositionCovarMatrix();
+    _SecLambda = Track->helixRep().secLambda();
+    //Neutral tracks are straight
+    _InvR = _TrackState->isCharged() ? Track->helixRep().invR() : 0.0;
+    
+    const HelixRep & H = Track->helixRep();
+    _D0 = H.d0();
+    _SinPhi = H.sinPhi();
+    _CosPhi = H.cosPhi();
+    if (_InvR != 0.0)
+    {
+      _CentreX = (H.radius() - _D0)*_SinPhi;
+      _CentreY = (_D0 - H.radius())*_CosPhi;
+      _AbsRadius = fabs(H.radius());
+    }
+    //Minimum over the Z residual of the quadratic form is RPhi^2.det(W)/W11
+    const double W00 = _InversePositionCovarMatrix(0,0);
+    const double W01 = _InversePositionCovarMatrix(0,1);
+    const double W11 = _InversePositionCovarMatrix(1,1);
+    _XYChi2Scale = (W11 > 0.0) ? std::max(0.0, W00 - W01*W01/W11) : 0.0;
+  }
+  
+	double GaussTube::chiSquaredLowerBound(const Vector3 & Point) const
+	{
+		double XYDistance;
+		if (_InvR != 0.0)
+			XYDistance = std::sqrt(pow(Point.x()-_CentreX,2) + pow(Point.y()-_CentreY,2)) - _AbsRadius;
+		else
+			//Neutral tracks pass through (d0.sinPhi,-d0.cosPhi), see TrackState::position()
+			XYDistance = Point.y()*_CosPhi - Point.x()*_SinPhi + _D0;
+		return _XYChi2Scale*XYDistance*XYDistance;
+	}
 	
-	double GaussTube::valueAt(const Vector3 & Point) const
+	void GaussTube::residual(const Vector3 & Point, TrackState & State, double & RPhi, double & Z) const
 	{
-		//Calculate value of UNNORMALISED gaussian at point from covarience matrix
-		boost::numeric::ublas::bounded_vector<double,2> Residual;
 		//XY Dist in 2D
-		_TrackState->swimToStateNearestXY(Point);
-		Residual(0) = _TrackState->xyDistanceTo(Point);
+		State.swimToStateNearestXY(Point);
+		RPhi = State.xyDistanceTo(Point);
 		//Z in 3D
-		_TrackState->swimToStateNearest(Point);
+		State.swimToStateNearest(Point);
 		//The 3Ddist , 2Ddist and distance on z plane form a right triangle, convert to zaxis by dividing by sin theta 
 		//Check hypotenuse longest
-		if (_TrackState->distanceTo(Point) < Residual(0)) 
-			Residual(1) = 0 ;
+		if (State.distanceTo(Point) < RPhi) 
+			Z = 0 ;
 		else
-			Residual(1) = sqrt(_TrackState->distanceTo2(Point)-pow(Residual(0),2))*sqrt(pow(_TrackState->parentTrack()->helixRep().tanLambda(),2)+1.0);
+			Z = sqrt(State.distanceTo2(Point)-pow(RPhi,2))*_SecLambda;
+	}
+	
+	double GaussTube::valueAt(const Vector3 & Point) const
+	{
+		return this->valueAt(Point,*_TrackState);
+	}
+	
+	double GaussTube::valueAt(const Vector3 & Point, TrackState & Scratch) const
+	{
+		//Calculate value of UNNORMALISED gaussian at point from covarience matrix
+		double Residual0,Residual1;
+		this->residual(Point,Scratch,Residual0,Residual1);
 		
 		// Value of tube = -0.5exp(res.inv(V).res) - Lyons pp 60
-		boost::numeric::ublas::bounded_vector<double,2> temp = prec_prod(_TrackState->inversePositionCovarMatrix(), Residual);
-		//std::cout << exp(-0.5 * prec_inner_prod(Residual,temp)) << std::endl;
-		return exp(-0.5 * prec_inner_prod(Residual,temp));
+		return exp(-0.5 * quadraticForm(_InversePositionCovarMatrix, Residual0, Residual1));
 				
 	}
+	
+	double GaussTube::valueAt(const Vector3 & Point, TrackState & Scratch, Vector3 & Gradient, SymMatrix3x3 * Hessian) const
+	{
+		//The tube is exp(-0.5 chi2) with chi2 = W00.A + 2W01.sec.sqrt(A.C) + W11.sec^2.C, where
+		//A = RPhi^2 is the squared XY distance, C = B-A the squared z part of the 3D distance B
+		//and sec = sqrt(1+tanLambda^2). For a distance to the track d^2 = |r|^2, r = Point-track(s)
+		//at the point of closest approach, grad d^2 = 2r and the second derivative is
+		//2(I - t.t/(t.t - r.dt/ds)) where t is the direction of the track.
+		
+		//XY Dist in 2D, as _residual
+		Scratch.swimToStateNearestXY(Point);
+		const double RPhi = Scratch.xyDistanceTo(Point);
+		const Vector3 XYPos = Scratch.position();
+		const Vector3 XYDir = Scratch.direction();
+		const Vector3 U(Point.x()-XYPos.x(),Point.y()-XYPos.y(),0.0);
+		
+		//Z in 3D
+		Scratch.swimToStateNearest(Point);
+		const double Dist3D = Scratch.distanceTo(Point);
+		const Vector3 Dir = Scratch.direction();
+		const Vector3 R = Point - Scratch.position();
+		
+		double Z = 0;
+		if (Dist3D >= RPhi)
+			Z = sqrt(Scratch.distanceTo2(Point)-pow(RPhi,2))*_SecLambda;
+		const double Value = exp(-0.5 * quadraticForm(_InversePositionCovarMatrix, RPhi, Z));
+		
+		const double W00 = _InversePositionCovarMatrix(0,0);
+		const double W01 = _InversePositionCovarMatrix(0,1);
+		const double W11 = _InversePositionCovarMatrix(1,1);
+		const double A = RPhi*RPhi;
+		const double C = (Dist3D >= RPhi) ? Scratch.distanceTo2(Point)-A : 0.0;
+		const double Sec2 = _SecLambda*_SecLambda;
+		
+		//Gradients of A and C (C is zero and flat when the 3D distance is not the longer)
+		const Vector3 GradA = U*2.0;
+		Vector3 GradC(0,0,0);
+		if (Dist3D >= RPhi)
+			GradC = R*2.0 - GradA;
+		
+		//chi2 gradient, the cross term has a cusp where A or C is zero so is left out there
+		Vector3 GradChi2 = GradA*W00 + GradC*(W11*Sec2);
+		const double Q = A*C;
+		const bool Cross = (W01 != 0.0 && Q > 0.0);
+		double SqrtQ = 0;
+		Vector3 GradQ(0,0,0);
+		if (Cross)
+		{
+			SqrtQ = sqrt(Q);
+			GradQ = GradA*C + GradC*A;
+			GradChi2 += GradQ*(W01*_SecLambda/SqrtQ);
+		}
+		Gradient = GradChi2*(-0.5*Value);
+		
+		if (Hessian)
+		{
+			//Second derivatives of A, in XY only, and of B
+			SymMatrix3x3 HessA;
+			HessA.clear();
+			HessA(0,0) = 2.0;
+			HessA(1,1) = 2.0;
+			const double DenA = 1.0 - _InvR*(U.x()*XYDir.y() - U.y()*XYDir.x());
+			if (DenA > 0)
+				addOuterProduct(HessA, -2.0/DenA, Vector3(XYDir.x(),XYDir.y(),0.0));
+			SymMatrix3x3 HessC;
+			HessC.clear();
+			if (Dist3D >= RPhi)
+			{
+				HessC(0,0) = 2.0;
+				HessC(1,1) = 2.0;
+				HessC(2,2) = 2.0;
+				const double DenB = Dir.dot(Dir) - _InvR*(R.x()*Dir.y() - R.y()*Dir.x());
+				if (DenB > 0)
+					addOuterProduct(HessC, -2.0/DenB, Dir);
+				HessC -= HessA;
+			}
+			
+			SymMatrix3x3 HessChi2 = HessA*W00 + HessC*(W11*Sec2);
+			if (Cross)
+			{
+				//Hessian of sqrt(Q) = H(Q)/2sqrt(Q) - grad(Q).grad(Q)/4Q^1.5
+				SymMatrix3x3 HessQ = HessA*C + HessC*A;
+				addOuterProduct(HessQ, 1.0, GradA, GradC);
+				const double Factor = W01*_SecLambda/SqrtQ;
+				HessChi2 += HessQ*Factor;
+				addOuterProduct(HessChi2, -0.5*Factor/Q, GradQ);
+			}
+			
+			//Hessian of exp(-chi2/2)
+			*Hessian = HessChi2*(-0.5*Value);
+			addOuterProduct(*Hessian, 0.25*Value, GradChi2);
+		}
+		return Value;
+	}
+	
+	TrackState GaussTube::makeScratch() const
+	{
+		return TrackState(_Track);
+	}
 
 	GaussTube::~GaussTube()
 	{
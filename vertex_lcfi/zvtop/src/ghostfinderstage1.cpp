@@ -96,6 +96,14 @@ namespace vertex_lcfi { namespace ZVTOP
 		return ResultGhost;
 	}
 
+	void GhostFinderStage1::valuesAt(const std::vector<std::vector<double> > & Angles, std::vector<double> & Values)
+	{
+		//Each point needs its own ghost track so there is nothing to share
+		Values.clear();
+		for (std::vector<std::vector<double> >::const_iterator iAngles = Angles.begin();iAngles < Angles.end();++iAngles)
+			Values.push_back(this->valueAt(*iAngles));
+	}
+
 	double GhostFinderStage1::valueAt(std::vector<double> CurrentAngles)
 	{
 		//We're working out the value of the Chi Squared at a perticular Ghost Track angle 
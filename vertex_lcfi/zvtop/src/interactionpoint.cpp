@@ -9,7 +9,7 @@ namespace vertex_lcfi { namespace ZVTOP
 	
 	InteractionPoint::InteractionPoint(const Vector3 & Position,const SymMatrix3x3 & ErrorMatrix)
           :_Position(Position),_ErrorMatrix(ErrorMatrix),
-           _InvErrorMatrix( InvertMatrix(ErrorMatrix) )
+           _InvErrorMatrix( InvertSymMatrix3x3(ErrorMatrix) )
 	{}
 	
 	double InteractionPoint::distanceTo(const Vector3 & Point) const
@@ -39,7 +39,7 @@ namespace vertex_lcfi { namespace ZVTOP
 		//std::cout << "Err: " << _InvErrorMatrix<< std::endl;
 		//std::cout << "Err: " << this->inverseErrorMatrix()<< std::endl;
 		//std::cout << "Chi2: " << prec_inner_prod(trans(Residual),prec_prod(this->inverseErrorMatrix(), Residual))<< std::endl<< std::endl;
-		return prec_inner_prod(trans(Residual),prec_prod(this->inverseErrorMatrix(), Residual));
+		return quadraticForm(this->inverseErrorMatrix(), Residual);
 	}
 }}
 
@@ -2,21 +2,177 @@
 
 #include "../../inc/track.h"
 #include "../include/candidatevertex.h"
+#include "../include/vertexfitterlsm.h"
+#include "../include/vertexfitcache.h"
 #include "../include/interactionpoint.h"
 #include "../include/vertexfunction.h"
 #include "../include/vertexfunctionclassic.h"
+#include "../include/vertexfuncmaxfinderclassicstepper.h"
+#include "../include/vertexfuncmaxfindertrustregion.h"
+#include "../include/vertexresolverequalsteps.h"
+#include "../include/vertexresolverbisection.h"
 #include "../../inc/trackstate.h"
 #include "../../util/inc/memorymanager.h"
+#include "../../util/inc/taskpool.h"
+#include "../../util/inc/pointgrid.h"
 #include <vector>
 #include <list>
 #include <ctime>
+#include <memory>
+#include <map>
+#include <algorithm>
 namespace vertex_lcfi { namespace ZVTOP
 {
-VertexFinderClassic::VertexFinderClassic(const std::vector<Track*> &Tracks, InteractionPoint* IP,const Vector3 &JetAxis,  double Kip, double Kalpha, double TwoProngCut, double TrackTrimCut, double ResolverCutOff)
-: _TrackList(Tracks),_IP(IP),_Kip(Kip),_Kalpha(Kalpha),_JetAxis(JetAxis),_TwoProngCut(TwoProngCut),_TrackTrimCut(TrackTrimCut),_ResolverCutOff(ResolverCutOff)
+namespace
 {
+	//Max finders hold working state, so one of each per thread. They must outlive the
+	//candidates of the event, which may find their maxima after findVertices returns
+	VertexFuncMaxFinder* maxFinderOfType(VertexFuncMaxFinderType Type)
+	{
+		static thread_local VertexFuncMaxFinderClassicStepper ClassicStepper;
+		static thread_local VertexFuncMaxFinderTrustRegion TrustRegion;
+		if (Type == TrustRegionMaxFinder)
+			return &TrustRegion;
+		return &ClassicStepper;
+	}
+
+	//A pool per calling thread, kept between jets
+	TaskPool* taskPool(unsigned int NumThreads)
+	{
+		static thread_local std::unique_ptr<TaskPool> Pool;
+		if (NumThreads == 0)
+			NumThreads = std::max(1u,std::thread::hardware_concurrency());
+		if (!Pool || Pool->numWorkers() != NumThreads)
+			Pool.reset(new TaskPool(NumThreads));
+		return Pool.get();
+	}
+
+	//Evaluates a shared vertex function through a scratch of its own, so that each
+	//thread can hand one to a max finder written for the single threaded valueAt(Point)
+	class ScratchVertexFunction :
+		public VertexFunction
+	{
+	public:
+		//Values are looked up in and added to Cache if given, which is not owned
+		explicit ScratchVertexFunction(const VertexFunction* Function, VertexFunctionCache* Cache = 0)
+		: _Function(Function)
+		{
+			_Function->makeScratch(_Scratch);
+			_Scratch.Cache = Cache;
+		}
+		double valueAt(const Vector3 & Point) const
+		{return _Function->valueAt(Point,_Scratch);}
+		double valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const
+		{return _Function->valueAt(Point,Scratch);}
+		void makeScratch(VertexFunctionScratch & Scratch) const
+		{_Function->makeScratch(Scratch);}
+		Vector3 firstDervAt(const Vector3 & Point) const
+		{
+			Vector3 Gradient;
+			_Function->valueAt(Point,Gradient,_Scratch);
+			return Gradient;
+		}
+		SymMatrix3x3 secondDervAt(const Vector3 & Point) const
+		{
+			Vector3 Gradient;
+			SymMatrix3x3 Hessian;
+			_Function->valueAt(Point,Gradient,Hessian,_Scratch);
+			return Hessian;
+		}
+		double valueAt(const Vector3 & Point, Vector3 & Gradient, VertexFunctionScratch & Scratch) const
+		{return _Function->valueAt(Point,Gradient,Scratch);}
+		double valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 & Hessian, VertexFunctionScratch & Scratch) const
+		{return _Function->valueAt(Point,Gradient,Hessian,Scratch);}
+	private:
+		const VertexFunction* _Function;
+		mutable VertexFunctionScratch _Scratch;
+	};
+
+	//What a worker needs to itself to fit candidates
+	struct TwoProngWorker
+	{
+		TwoProngWorker(const VertexFunction* Function, VertexFunctionCache* Cache, const std::vector<TrackState*> & TrackStates)
+		: VF(Function,Cache)
+		{
+			for (std::vector<TrackState*>::const_iterator iTrack = TrackStates.begin();iTrack != TrackStates.end();++iTrack)
+				Tracks.push_back(**iTrack);
+		}
+		CandidateVertex::FallbackVertexFitter Fitter;
+		std::vector<TrackState> Tracks;
+		ScratchVertexFunction VF;
+	};
+
+	//Fit of one candidate made on a worker
+	struct TwoProngFit
+	{
+		Vector3 Position;
+		double ChiSquaredOfFit;
+		std::vector<double> ChiSquaredOfTrack;
+		double ChiSquaredOfIP;
+		double VertexFuncValue;
+	};
+
+	//Union-find over indices, each set is named by its lowest index
+	class DisjointSets
+	{
+	public:
+		explicit DisjointSets(std::size_t Size)
+		: _Parent(Size)
+		{
+			for (std::size_t i = 0;i < Size;++i)
+				_Parent[i] = i;
+		}
+		std::size_t find(std::size_t i)
+		{
+			//Path halving
+			while (_Parent[i] != i)
+			{
+				_Parent[i] = _Parent[_Parent[i]];
+				i = _Parent[i];
+			}
+			return i;
+		}
+		void join(std::size_t i, std::size_t j)
+		{
+			i = this->find(i);
+			j = this->find(j);
+			if (i < j)
+				_Parent[j] = i;
+			else if (j < i)
+				_Parent[i] = j;
+		}
+	private:
+		std::vector<std::size_t> _Parent;
+	};
+}
+
+VertexFinderClassic::VertexFinderClassic(const std::vector<Track*> &Tracks, InteractionPoint* IP,const Vector3 &JetAxis,  double Kip, double Kalpha, double TwoProngCut, double TrackTrimCut, double ResolverCutOff, VertexFunctionPrecision Precision, VertexFuncMaxFinderType MaxFinderType, double TubeCullEpsilon, double CacheGridSize)
+: _TrackList(Tracks),_IP(IP),_MaxFinder(maxFinderOfType(MaxFinderType)),_MaxFinderType(MaxFinderType),_Kip(Kip),_Kalpha(Kalpha),_JetAxis(JetAxis),_TwoProngCut(TwoProngCut),_TrackTrimCut(TrackTrimCut),_ResolverCutOff(ResolverCutOff),_Precision(Precision),_TubeCullEpsilon(TubeCullEpsilon),_CacheGridSize(CacheGridSize)
+{
+}
+
+
+void VertexFinderClassic::setResolver(VertexResolverType Type, int NumSteps, int Refinements)
+{
+	_ResolverType = Type;
+	_ResolverSteps = NumSteps;
+	_ResolverRefinements = Refinements;
 }
 
+void VertexFinderClassic::setNumThreads(unsigned int NumThreads)
+{
+	_NumThreads = NumThreads;
+}
+
+void VertexFinderClassic::setResolverRadius(double Radius)
+{
+	_ResolverRadius = Radius;
+}
+
+void VertexFinderClassic::setFitCache(bool Enable)
+{
+	_UseFitCache = Enable;
+}
 
 void VertexFinderClassic::addTrack(Track* const Track)
 {
@@ -112,8 +268,20 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	using std::cout;using std::endl;clock_t start,pstart;int debug=0;
 	//Make vertex function
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "Constructing Vertex Function....."; cout.flush();pstart=clock();}start=clock();
-	_VF = new VertexFunctionClassic(_TrackList,_IP,_Kip,_Kalpha,_JetAxis);
-	MemoryManager<VertexFunctionClassic>::Event()->registerObject(dynamic_cast<VertexFunctionClassic*>(_VF));
+	VertexFunctionClassic* VFClassic = new VertexFunctionClassic(_TrackList,_IP,_Kip,_Kalpha,_JetAxis);
+	VFClassic->setPrecision(_Precision);
+	VFClassic->setCullEpsilon(_TubeCullEpsilon);
+	if (_CacheGridSize >= 0.0)
+		VFClassic->enableCache(_CacheGridSize);
+	_VF = VFClassic;
+	MemoryManager<VertexFunctionClassic>::Event()->registerObject(VFClassic);
+	//Resolvers are kept for the event as the candidates may be resolved after findVertices returns
+	if (_ResolverType == BisectionResolver)
+		_Resolver = MemoryManager<VertexResolverBisection>::Event()->make(_ResolverSteps,_ResolverRefinements);
+	else
+		_Resolver = MemoryManager<VertexResolverEqualSteps>::Event()->make();
+	//Like the resolver the cache stays with the candidates until the end of the event
+	_FitCache = _UseFitCache ? MemoryManager<VertexFitCache>::Event()->make() : 0;
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "\tdone!\t\t\t" << ((double)clock()-(double)pstart)*1000.0/CLOCKS_PER_SEC << "ms" << endl; cout.flush();}
 	//Make two prong candidates, discarding if above chi squared cut, remembering to assign vertex function
 	//std::cout << "1";
@@ -123,14 +291,24 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug<0) std::cout << std::endl;
 	//Iterate over the track list making unique 2-prong candidates containing two trackstates
 	int N = _TrackList.size();
-	//Make trackstates of the tracks
+	//Make trackstates of the tracks, indexed by their place in the track list so candidates can keep their tracks as bits
 	std::vector<TrackState*> TrackStates;
 	for (std::vector<Track*>::iterator iTrack = _TrackList.begin();iTrack != _TrackList.end();++iTrack)
 	{
 		TrackState* Track = (*iTrack)->makeState(); 
+		Track->setTableIndex(int(TrackStates.size()));
 		TrackStates.push_back(Track);
 	}
-	for (int OuterIndex=0;OuterIndex < N-1;++OuterIndex)
+	//The pool makes the same candidates, those with the IP too, when threaded
+	const bool Serial = (_NumThreads == 1);
+	//The function's own cache is not thread safe, so each worker keeps one for the jet
+	_WorkerCaches.clear();
+	if (!Serial && _CacheGridSize >= 0.0)
+		for (unsigned int Worker = 0;Worker < taskPool(_NumThreads)->numWorkers();++Worker)
+			_WorkerCaches.push_back(std::unique_ptr<VertexFunctionCache>(new VertexFunctionCache(_CacheGridSize)));
+	if (!Serial)
+		this->_makeTwoProngsInParallel(TrackStates,&CVList);
+	for (int OuterIndex=0;Serial && OuterIndex < N-1;++OuterIndex)
 	{
 		for (int InnerIndex=OuterIndex+1;InnerIndex < N;++InnerIndex)
 			{
@@ -138,8 +316,10 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 				Tracks.push_back(TrackStates[OuterIndex]);
 				Tracks.push_back(TrackStates[InnerIndex]);
 				
-				CandidateVertex* CV = new CandidateVertex(Tracks,_VF);
-				MemoryManager<CandidateVertex>::Event()->registerObject(CV);
+				CandidateVertex* CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,_VF);
+				CV->setMaxFinder(_MaxFinder);
+				CV->setResolver(_Resolver);
+				CV->setFitCache(_FitCache);
 				//If we keep this one as chi squared lower than cut we add it to our lists
 				//TODO cut on V(r) from FORTRAN, keep?
 				/*ofstream case2file ("chi2track.txt", ofstream::out | ofstream::app);
@@ -168,15 +348,17 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	//int NumBefore = CVList.size();
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "Track+IP....."; cout.flush();}
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug<0) std::cout << std::endl;
-	if (_IP)
+	if (_IP && Serial)
 	{
 		for (int Index=0;Index < N;++Index)
 			{
 				std::vector<TrackState*> Tracks;
 				Tracks.push_back(TrackStates[Index]);
 				
-				CandidateVertex* CV = new CandidateVertex(Tracks,_IP,_VF);
-				MemoryManager<CandidateVertex>::Event()->registerObject(CV);
+				CandidateVertex* CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,_IP,_VF);
+				CV->setMaxFinder(_MaxFinder);
+				CV->setResolver(_Resolver);
+				CV->setFitCache(_FitCache);
 				/*ofstream case2file ("chiip.txt", ofstream::out | ofstream::app);
 					if (case2file.is_open())
 					{
@@ -201,8 +383,7 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	/*if (_IP && (NumBefore == CVList.size()))
 	{
 		std::vector<TrackState*> Tracks;
-		CandidateVertex* CV = new CandidateVertex(Tracks,_IP,_VF);
-		MemoryManager<CandidateVertex>::Event()->registerObject(CV);
+		CandidateVertex* CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,_IP,_VF);
 		CVList.push_back(CV);
 	}
 	*/
@@ -212,7 +393,9 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	//if (CVList.empty()) return CVList;
 	
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "Find V(r) max....."; cout.flush();pstart=clock();}
-	for (std::list<CandidateVertex*>::iterator iCV = CVList.begin();iCV != CVList.end();++iCV)
+	if (!Serial)
+		this->_findVertexFuncMaxInParallel(CVList);
+	for (std::list<CandidateVertex*>::iterator iCV = CVList.begin();Serial && iCV != CVList.end();++iCV)
 		{
 			(*iCV)->findVertexFuncMax();
 		}
@@ -222,15 +405,15 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	//We now make sure the track k is only associated with the CV with highest
 	//V(r) at fitted position (not nearest maxima) in any unresolved set currently associated with the track
 	std::vector<CandidateVertex*> RemoveFrom;
-	std::vector<Track*> TrackToRemove;
+	std::vector<TrackState*> TrackToRemove;
 	//Loop over tracks
-	for (std::vector<Track*>::iterator iTrack = _TrackList.begin();iTrack != _TrackList.end();++iTrack)
+	for (std::vector<TrackState*>::iterator iTrack = TrackStates.begin();iTrack != TrackStates.end();++iTrack)
 	{
 		//Get a list of the CV's associated with this Track
 		std::list<CandidateVertex*> AssocCVs;
 		for (std::list<CandidateVertex*>::iterator iCV = CVList.begin();iCV != CVList.end();++iCV)
 		{
-			if ((*iCV)->hasTrack(*iTrack)) AssocCVs.push_back(*iCV);
+			if ((*iCV)->hasTrackOf(*iTrack)) AssocCVs.push_back(*iCV);
 		}
 		if (AssocCVs.empty())
 		{
@@ -261,6 +444,9 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
             		bool resolved = true;
             		for (std::list<CandidateVertex*>::iterator iRetainedCV = RetainedCVs.begin();iRetainedCV != RetainedCVs.end();++iRetainedCV)
 	            	{
+				//Beyond the resolver radius taken as resolved
+				if (_ResolverRadius > 0.0 && (*iCV)->position().distanceTo((*iRetainedCV)->position()) > _ResolverRadius)
+					continue;
 				resolved = (*iCV)->isResolvedFrom((*iRetainedCV),_ResolverCutOff, CandidateVertex::FittedPosition);
                 		//If we were not resolved then theres no need to check the rest
                	 		if (!resolved) 
@@ -277,10 +463,10 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	    	}
 	}
 	//Now go over the list we just made removing tracks
-	std::vector<Track*>::iterator iTrack = TrackToRemove.begin();
+	std::vector<TrackState*>::iterator iTrack = TrackToRemove.begin();
 	for (std::vector<CandidateVertex*>::iterator iCV = RemoveFrom.begin();iCV != RemoveFrom.end();++iCV)
 	{
-		(*iCV)->removeTrack(*iTrack);
+		(*iCV)->removeTrackOf(*iTrack);
 		++iTrack;
 	}
 	//std::cout << "3";
@@ -328,60 +514,59 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "\t\t\tdone!" << " "<< CVList.size() << " Vertices" << "\t" << ((double(clock())-double(pstart))/CLOCKS_PER_SEC)*1000 << "ms" << endl; cout.flush();}
 	///std::cout << "5";
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "Clustering by V(r)Max resolution....."; cout.flush();pstart=clock();}
-	//Get lists of CV's that are unresolved. then merge.
+	//Get sets of CV's that are unresolved. then merge.
 	if (!CVList.empty())
 	{
-		std::list<std::list<CandidateVertex*> > ClusterLists;
-		do
+		//Index the CV's in descending V(r) max order, the pairs not resolved from each other
+		//are the edges of a graph whose connected components are the clusters
+		const std::vector<CandidateVertex*> Candidates(CVList.begin(),CVList.end());
+		const std::size_t NumCandidates = Candidates.size();
+		const std::vector<std::vector<std::size_t> > Unresolved = this->_unresolvedPairs(Candidates);
+		DisjointSets Components(NumCandidates);
+		std::vector<std::vector<std::size_t> > Neighbours(NumCandidates);
+		for (std::size_t i = 0;i < NumCandidates;++i)
+			for (std::vector<std::size_t>::const_iterator j = Unresolved[i].begin();j != Unresolved[i].end();++j)
+			{
+				Components.join(i,*j);
+				//Filled by ascending i so each list of neighbours is in ascending order
+				Neighbours[i].push_back(*j);
+				Neighbours[*j].push_back(i);
+			}
+		//Each component is seeded by its highest V(r) max, its lowest index. The members are
+		//listed breadth first from the seed taking neighbours in V(r) max order, the order
+		//they were found in by growing the cluster a CV at a time, which sets the merge order
+		std::list<std::vector<CandidateVertex*> > ClusterLists;
+		std::vector<bool> Clustered(NumCandidates,false);
+		for (std::size_t Seed = 0;Seed < NumCandidates;++Seed)
 		{
-			//Get the CV with highest v(r) as seed for a cluster
-			CandidateVertex* Seed = *CVList.begin();
-			//Remove it from the CV list
-			CVList.erase(CVList.begin());
-			//Add it to its cluster
-			std::list<CandidateVertex*> Cluster;
-			Cluster.push_back(Seed);
-			int added = 0;
-			do 
+			if (Components.find(Seed) != Seed)
+				continue;
+			std::vector<std::size_t> Members(1,Seed);
+			Clustered[Seed] = true;
+			for (std::size_t iMember = 0;iMember < Members.size();++iMember)
 			{
-				//Iterate over cluster
-				added = 0;
-				std::list<CandidateVertex*>::iterator iCVertex;
-				for (iCVertex=Cluster.begin();iCVertex != Cluster.end();++iCVertex)
-				{
-					//Iterate over the remaining CV's
-					std::list<CandidateVertex*>::iterator iVertex;
-					for (iVertex=CVList.begin();iVertex != CVList.end();++iVertex)
+				const std::vector<std::size_t> & Next = Neighbours[Members[iMember]];
+				for (std::vector<std::size_t>::const_iterator j = Next.begin();j != Next.end();++j)
+					if (!Clustered[*j])
 					{
-						//If not resolved
-						if (!(*iCVertex)->isResolvedFrom(*iVertex,_ResolverCutOff, CandidateVertex::NearestMaximum))
-						{
-							//Add to this Cluster
-							Cluster.push_back(*iVertex);
-							++added;
-						}
+						Clustered[*j] = true;
+						Members.push_back(*j);
 					}
-					//Remove from the CVList
-					for (std::list<CandidateVertex*>::iterator iCVertex2=Cluster.begin();iCVertex2 != Cluster.end();++iCVertex2)
-					{
-						CVList.remove(*iCVertex2);
-					}
-							
-				}
-				//Keep looping over the cluster till none added
-			} while (added > 0);
-			//Add the cluster the cluster list
+			}
+			std::vector<CandidateVertex*> Cluster;
+			for (std::vector<std::size_t>::const_iterator iMember = Members.begin();iMember != Members.end();++iMember)
+				Cluster.push_back(Candidates[*iMember]);
 			ClusterLists.push_back(Cluster);
 		}
-		while (!CVList.empty());
+		CVList.clear();
 		/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "\tdone!" <<  "\t\t\t" << ((double(clock())-double(pstart))/CLOCKS_PER_SEC)*1000 << "ms" << endl; cout.flush();}
 		/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug>1) {for (std::list<CandidateVertex*>::iterator iCV = CVList.begin();iCV != CVList.end();++iCV) cout << **iCV <<endl;}
 		/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "Merging....."; cout.flush();pstart=clock();}
 		//We now have nice lists of clusters, so we can merge away
-		std::list<std::list<CandidateVertex*> >::iterator iList;
+		std::list<std::vector<CandidateVertex*> >::iterator iList;
 		for (iList=ClusterLists.begin();iList != ClusterLists.end();++iList)
 		{
-			std::list<CandidateVertex*>::iterator iVertex;
+			std::vector<CandidateVertex*>::iterator iVertex;
 			for (iVertex=(++((*iList).begin()));iVertex != (*iList).end(); ++iVertex)
 			{
 				(*((*iList).begin()))->mergeCandidateVertex(*iVertex);
@@ -447,6 +632,9 @@ std::list<CandidateVertex*> VertexFinderClassic::findVertices()
 	//outfile <<  _TrackList.size() << " " << (double(clock())-double(start))/CLOCKS_PER_SEC*1000.0 << std::endl;
 	//std::cout << "7";
 	CVList.sort(IPDistAscending(_IP));
+	for (std::vector<std::unique_ptr<VertexFunctionCache> >::const_iterator iCache = _WorkerCaches.begin();iCache != _WorkerCaches.end();++iCache)
+		VertexFunctionClassic::countCacheLookups(**iCache);
+	_WorkerCaches.clear();
 	//Done
 	return CVList;
 }	
@@ -482,9 +670,158 @@ void VertexFinderClassic::_ifNoIPAddIP(std::list<CandidateVertex*>* CVList)
 	}
 	//None was found so add one!
 	std::vector<TrackState*> Tracks;
-	CandidateVertex* CV = new CandidateVertex(Tracks,_IP,_VF);
-	MemoryManager<CandidateVertex>::Event()->registerObject(CV);
+	CandidateVertex* CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,_IP,_VF);
+	CV->setMaxFinder(_MaxFinder);
+	CV->setResolver(_Resolver);
+	CV->setFitCache(_FitCache);
 	CVList->push_back(CV);
 }
 
+void VertexFinderClassic::_makeTwoProngsInParallel(const std::vector<TrackState*> & TrackStates, std::list<CandidateVertex*>* CVList)
+{
+	//Same candidates in the same order as the serial loops, track pairs then each track with the IP
+	const int N = TrackStates.size();
+	std::vector<std::pair<int,int> > Candidates;
+	for (int OuterIndex=0;OuterIndex < N-1;++OuterIndex)
+		for (int InnerIndex=OuterIndex+1;InnerIndex < N;++InnerIndex)
+			Candidates.push_back(std::make_pair(OuterIndex,InnerIndex));
+	if (_IP)
+		for (int Index=0;Index < N;++Index)
+			Candidates.push_back(std::make_pair(Index,-1));
+
+	//Fit each on a worker, from copies of the trackstates as they were made so that no
+	//candidate sees the swims of another
+	TaskPool* Pool = taskPool(_NumThreads);
+	std::vector<std::unique_ptr<TwoProngWorker> > Workers(Pool->numWorkers());
+	std::vector<TwoProngFit> Fits(Candidates.size());
+	Pool->run(Candidates.size(),[&](std::size_t Task, unsigned int Worker)
+	{
+		if (!Workers[Worker])
+			Workers[Worker].reset(new TwoProngWorker(_VF,_workerCache(Worker),TrackStates));
+		TwoProngWorker & W = *Workers[Worker];
+		const std::pair<int,int> & Candidate = Candidates[Task];
+		const bool WithIP = (Candidate.second < 0);
+		std::vector<TrackState*> Tracks;
+		W.Tracks[Candidate.first] = *TrackStates[Candidate.first];
+		Tracks.push_back(&W.Tracks[Candidate.first]);
+		if (!WithIP)
+		{
+			W.Tracks[Candidate.second] = *TrackStates[Candidate.second];
+			Tracks.push_back(&W.Tracks[Candidate.second]);
+		}
+		TwoProngFit & Fit = Fits[Task];
+		W.Fitter.fitVertex(Tracks,WithIP ? _IP : 0,Fit.Position,Fit.ChiSquaredOfFit,Fit.ChiSquaredOfTrack,Fit.ChiSquaredOfIP);
+		Fit.VertexFuncValue = WithIP ? 0.0 : W.VF.valueAt(Fit.Position);
+	});
+
+	//Make the candidates on this thread, so they belong to its MemoryManager, applying the same cuts
+	for (std::size_t Task = 0;Task < Candidates.size();++Task)
+	{
+		const std::pair<int,int> & Candidate = Candidates[Task];
+		const TwoProngFit & Fit = Fits[Task];
+		std::vector<TrackState*> Tracks;
+		Tracks.push_back(TrackStates[Candidate.first]);
+		CandidateVertex* CV;
+		if (Candidate.second < 0)
+		{
+			CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,_IP,_VF);
+		}
+		else
+		{
+			Tracks.push_back(TrackStates[Candidate.second]);
+			CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,_VF);
+		}
+		CV->setMaxFinder(_MaxFinder);
+		CV->setResolver(_Resolver);
+		CV->setFitCache(_FitCache);
+		CV->setFit(Fit.Position,Fit.ChiSquaredOfFit,Fit.ChiSquaredOfTrack,Fit.ChiSquaredOfIP);
+		if (CV->maxChiSquaredOfTrackIP() <= _TwoProngCut && (Candidate.second < 0 || Fit.VertexFuncValue>0.001))
+			CVList->push_back(CV);
+	}
+}
+
+std::vector<std::vector<std::size_t> > VertexFinderClassic::_unresolvedPairs(const std::vector<CandidateVertex*> & Candidates) const
+{
+	//Each pair is resolved from the one earlier in the list, as when clusters were grown from their seeds
+	const std::size_t NumCandidates = Candidates.size();
+	std::vector<std::vector<std::size_t> > Unresolved(NumCandidates);
+
+	//Only pairs of maxima within the resolver radius are tested, the rest are resolved
+	std::vector<Vector3> Maxima;
+	for (std::vector<CandidateVertex*>::const_iterator iCV = Candidates.begin();iCV != Candidates.end();++iCV)
+		Maxima.push_back((*iCV)->vertexFuncMaxPosition());
+	std::unique_ptr<PointGrid> Grid;
+	if (_ResolverRadius > 0.0)
+		Grid.reset(new PointGrid(Maxima,_ResolverRadius));
+	//The candidates after i to test against it, in order
+	auto laterNear = [&](std::size_t i, std::vector<std::size_t> & Near)
+	{
+		Near.clear();
+		if (Grid)
+		{
+			Grid->pointsWithin(Maxima[i],_ResolverRadius,Near);
+			Near.erase(Near.begin(),std::upper_bound(Near.begin(),Near.end(),i));
+		}
+		else
+			for (std::size_t j = i+1;j < NumCandidates;++j)
+				Near.push_back(j);
+	};
+
+	if (_NumThreads == 1)
+	{
+		std::vector<std::size_t> Near;
+		for (std::size_t i = 0;i < NumCandidates;++i)
+		{
+			laterNear(i,Near);
+			for (std::vector<std::size_t>::const_iterator j = Near.begin();j != Near.end();++j)
+				if (!Candidates[i]->isResolvedFrom(Candidates[*j],_ResolverCutOff,CandidateVertex::NearestMaximum))
+					Unresolved[i].push_back(*j);
+		}
+		return Unresolved;
+	}
+
+	//The maxima are all found so the candidates only read, the resolver is asked directly
+	//so that the vertex function is evaluated through the worker's scratch
+	TaskPool* Pool = taskPool(_NumThreads);
+	std::vector<std::unique_ptr<ScratchVertexFunction> > Functions(Pool->numWorkers());
+	Pool->run(NumCandidates,[&](std::size_t i, unsigned int Worker)
+	{
+		if (!Functions[Worker])
+			Functions[Worker].reset(new ScratchVertexFunction(_VF,_workerCache(Worker)));
+		const CandidateVertex* CV = Candidates[i];
+		std::vector<std::size_t> Near;
+		laterNear(i,Near);
+		for (std::vector<std::size_t>::const_iterator j = Near.begin();j != Near.end();++j)
+			if (!_Resolver->areResolved(Maxima[i],Maxima[*j],CV->vertexFuncMaxValue(),Candidates[*j]->vertexFuncMaxValue(),Functions[Worker].get(),_ResolverCutOff))
+				Unresolved[i].push_back(*j);
+	});
+	return Unresolved;
+}
+
+VertexFunctionCache* VertexFinderClassic::_workerCache(unsigned int Worker) const
+{
+	if (_WorkerCaches.empty())
+		return 0;
+	return _WorkerCaches[Worker].get();
+}
+
+void VertexFinderClassic::_findVertexFuncMaxInParallel(const std::list<CandidateVertex*> & CVList)
+{
+	//The candidates are all fitted, so position() only reads and each task writes to its own candidate
+	const std::vector<CandidateVertex*> Candidates(CVList.begin(),CVList.end());
+	TaskPool* Pool = taskPool(_NumThreads);
+	std::vector<std::unique_ptr<ScratchVertexFunction> > Functions(Pool->numWorkers());
+	Pool->run(Candidates.size(),[&](std::size_t Task, unsigned int Worker)
+	{
+		if (!Functions[Worker])
+			Functions[Worker].reset(new ScratchVertexFunction(_VF,_workerCache(Worker)));
+		ScratchVertexFunction* VF = Functions[Worker].get();
+		//The max finder of this worker's thread
+		VertexFuncMaxFinder* MaxFinder = maxFinderOfType(_MaxFinderType);
+		CandidateVertex* CV = Candidates[Task];
+		const Vector3 MaxPosition = MaxFinder->findNearestMaximum(CV->position(),VF);
+		CV->setVertexFuncMax(MaxPosition,VF->valueAt(MaxPosition));
+	});
+}
+
 }}
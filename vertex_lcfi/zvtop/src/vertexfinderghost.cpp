@@ -2,6 +2,7 @@
 
 #include "../../inc/track.h"
 #include "../include/candidatevertex.h"
+#include "../include/vertexfitcache.h"
 #include "../include/interactionpoint.h"
 #include "../include/vertexfunction.h"
 #include "../include/vertexfunctionclassic.h"
@@ -94,8 +95,7 @@ std::list<CandidateVertex*> VertexFinderGhost::findVertices()
         else
         {
             std::list<CandidateVertex*> ret;
-            CandidateVertex* CV = new CandidateVertex(std::vector<TrackState*>(),_IP,0);
-            MemoryManager<CandidateVertex>::Event()->registerObject(CV);
+            CandidateVertex* CV = MemoryManager<CandidateVertex>::Event()->make(std::vector<TrackState*>(),_IP,(VertexFunction*)0);
             ret.push_back(CV);
             return ret;
         }
@@ -105,15 +105,19 @@ std::list<CandidateVertex*> VertexFinderGhost::findVertices()
 	Track* GhostTrack = GhostFinderStage1().findGhost(_InitialGhostWidth,_MaxChi2Allowed,_SeedDirection,_TrackList,_IP);
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "\tdone!\t\t\t" << ((double)clock()-(double)pstart)*1000.0/CLOCKS_PER_SEC << "ms" << endl; cout.flush();}
 	
-	//Make trackstates of the tracks
+	//Make trackstates of the tracks, indexed by their place in the track list with the ghost last so fits can be cached
 	std::vector<TrackState*> TrackStates;
 	for (std::vector<Track*>::iterator iTrack = _TrackList.begin();iTrack != _TrackList.end();++iTrack)
 	{
 		TrackState* Track = (*iTrack)->makeState(); 
+		Track->setTableIndex(int(TrackStates.size()));
 		TrackStates.push_back(Track);
 	}
 	//And of the ghost
 	TrackState* GhostTrackState = GhostTrack->makeState();
+	GhostTrackState->setTableIndex(int(TrackStates.size()));
+	//Trial merges take the cache from the candidates they merge
+	VertexFitCache* FitCache = _UseFitCache ? MemoryManager<VertexFitCache>::Event()->make() : 0;
 	
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "Generating 1-prong Candidate Vertices + IP...."; cout.flush();start=clock();}
 	//Then we make a list of all the 1 prong (Ghost + 1 track) vertices
@@ -125,15 +129,15 @@ std::list<CandidateVertex*> VertexFinderGhost::findVertices()
 		std::vector<TrackState*> Tracks;
 		Tracks.push_back(*iTrack);
 		Tracks.push_back(GhostTrackState);
-		CandidateVertex* CV = new CandidateVertex(Tracks,(InteractionPoint*)0,0);
-		MemoryManager<CandidateVertex>::Event()->registerObject(CV);
+		CandidateVertex* CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,(InteractionPoint*)0,(VertexFunction*)0);
+		CV->setFitCache(FitCache);
 		Candidates.push_back(CV);
 	}
 	//And add a CV with just the IP
 	{
 		std::vector<TrackState*> Tracks;
-		CandidateVertex* CV = new CandidateVertex(Tracks,_IP,0);
-		MemoryManager<CandidateVertex>::Event()->registerObject(CV);
+		CandidateVertex* CV = MemoryManager<CandidateVertex>::Event()->make(Tracks,_IP,(VertexFunction*)0);
+		CV->setFitCache(FitCache);
 		Candidates.push_back(CV);		
 	}
 	/*////////////////////////////////////////////////////////DEBUGLINE*/if (debug) {cout << "\tdone!" << " "<< Candidates.size() << " Candidates" << "\t" << ((double(clock())-double(start))/CLOCKS_PER_SEC)*1000 << "ms" <<endl; cout.flush();}
@@ -154,8 +158,7 @@ std::list<CandidateVertex*> VertexFinderGhost::findVertices()
 			ToMerge.push_back(*iOuterCV);
 			ToMerge.push_back(*iInnerCV);
 			
-			CandidateVertex* Merged = new CandidateVertex(ToMerge);
-			MemoryManager<CandidateVertex>::Event()->registerObject(Merged);
+			CandidateVertex* Merged = MemoryManager<CandidateVertex>::Event()->make(ToMerge);
 			//If we merged the ghost and ip, just keep the IP
 			if (Merged->hasTrack(GhostTrack) && Merged->interactionPoint())
 			{
@@ -235,8 +238,7 @@ std::list<CandidateVertex*> VertexFinderGhost::findVertices()
 					ToMerge.push_back(MostProbableVertex);
 					ToMerge.push_back(*iCV);
 					
-					CandidateVertex* Merged = new CandidateVertex(ToMerge);
-					MemoryManager<CandidateVertex>::Event()->registerObject(Merged);
+					CandidateVertex* Merged = MemoryManager<CandidateVertex>::Event()->make(ToMerge);
 					TrialMergedCandidates.push_back(Merged);
 					
 					VerticesContainedIn[Merged] = ToMerge;
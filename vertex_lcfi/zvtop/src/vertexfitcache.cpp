@@ -0,0 +1,91 @@
+#include "../include/vertexfitcache.h"
+#include "../../inc/trackstate.h"
+
+namespace vertex_lcfi { namespace ZVTOP
+{
+	VertexFitCache::~VertexFitCache()
+	{
+		FitCacheStatistics & Statistics = _cacheStatistics();
+		Statistics.Hits += _Hits;
+		Statistics.Misses += _Misses;
+	}
+
+	bool VertexFitCache::Key::operator<(const Key & Other) const
+	{
+		if (IP != Other.IP)
+			return IP < Other.IP;
+		if (Fitter != Other.Fitter)
+			return Fitter < Other.Fitter;
+		return Tracks < Other.Tracks;
+	}
+
+	bool VertexFitCache::_key(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, VertexFitter* Fitter, Key & Result)
+	{
+		Result.Tracks.clear();
+		Result.Tracks.reserve(Tracks.size());
+		for (std::vector<TrackState*>::const_iterator iTrack = Tracks.begin();iTrack != Tracks.end();++iTrack)
+		{
+			if ((*iTrack)->tableIndex() < 0)
+				return false;
+			Result.Tracks.push_back((*iTrack)->tableIndex());
+		}
+		Result.IP = IP;
+		Result.Fitter = Fitter;
+		return true;
+	}
+
+	bool VertexFitCache::find(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, VertexFitter* Fitter, bool NeedError, Vector3 & Position, Matrix3x3 & PositionError, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack, double & ChiSquaredOfIP)
+	{
+		Key K;
+		if (!_key(Tracks,IP,Fitter,K))
+			return false;
+		std::map<Key,Fit>::const_iterator iFit = _Fits.find(K);
+		if (iFit == _Fits.end() || (NeedError && !iFit->second.ErrorIsValid))
+		{
+			++_Misses;
+			return false;
+		}
+		const Fit & F = iFit->second;
+		Position = F.Position;
+		if (NeedError)
+			PositionError = F.PositionError;
+		ChiSquaredOfFit = F.ChiSquaredOfFit;
+		ChiSquaredOfTrack = F.ChiSquaredOfTrack;
+		ChiSquaredOfIP = F.ChiSquaredOfIP;
+		++_Hits;
+		return true;
+	}
+
+	void VertexFitCache::insert(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, VertexFitter* Fitter, const Vector3 & Position, const Matrix3x3 * PositionError, double ChiSquaredOfFit, const std::vector<double> & ChiSquaredOfTrack, double ChiSquaredOfIP)
+	{
+		Key K;
+		if (!_key(Tracks,IP,Fitter,K))
+			return;
+		Fit & F = _Fits[K];
+		F.Position = Position;
+		F.ErrorIsValid = (PositionError != 0);
+		if (PositionError)
+			F.PositionError = *PositionError;
+		F.ChiSquaredOfFit = ChiSquaredOfFit;
+		F.ChiSquaredOfTrack = ChiSquaredOfTrack;
+		F.ChiSquaredOfIP = ChiSquaredOfIP;
+	}
+
+	FitCacheStatistics & VertexFitCache::_cacheStatistics()
+	{
+		static thread_local FitCacheStatistics Statistics = {0,0};
+		return Statistics;
+	}
+
+	const FitCacheStatistics & VertexFitCache::cacheStatistics()
+	{
+		return _cacheStatistics();
+	}
+
+	void VertexFitCache::resetCacheStatistics()
+	{
+		FitCacheStatistics & Statistics = _cacheStatistics();
+		Statistics.Hits = 0;
+		Statistics.Misses = 0;
+	}
+}}
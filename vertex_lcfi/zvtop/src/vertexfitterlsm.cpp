@@ -166,6 +166,34 @@ namespace vertex_lcfi { namespace ZVTOP
 	void VertexFitterLSM::fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, Matrix3x3 & ResultError, double & ChiSquaredOfFit, std::map<TrackState*,double> & ChiSquaredOfTrack,double & ChiSquaredOfIP)
 	{
 		this->fitVertex(Tracks,IP,Result,ChiSquaredOfFit,ChiSquaredOfTrack,ChiSquaredOfIP);
+		this->_fitError(Tracks,IP,Result,ResultError);
+	}
+
+	void VertexFitterLSM::fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack,double & ChiSquaredOfIP)
+	{
+		this->fitVertex(Tracks,IP,Result);
+		//fill in ChiSquaredOfTrack and of fit
+		ChiSquaredOfFit = 0;
+		ChiSquaredOfTrack.clear();
+		for( std::vector<TrackState*>::const_iterator i=Tracks.begin(); i<Tracks.end(); i++ )
+		{
+			double chi = _chi2Contribution( Result, (*i) );
+			ChiSquaredOfTrack.push_back( chi );
+			ChiSquaredOfFit += chi;
+		}
+		//fill in ChiSquaredOfIP if no IP this just gives zero
+		ChiSquaredOfIP=_chi2Contribution( Result, IP );
+		ChiSquaredOfFit += ChiSquaredOfIP;
+	}
+
+	void VertexFitterLSM::fitVertex(const std::vector<TrackState*> & Tracks, InteractionPoint* IP, Vector3 & Result, Matrix3x3 & ResultError, double & ChiSquaredOfFit, std::vector<double> & ChiSquaredOfTrack,double & ChiSquaredOfIP)
+	{
+		this->fitVertex(Tracks,IP,Result,ChiSquaredOfFit,ChiSquaredOfTrack,ChiSquaredOfIP);
+		this->_fitError(Tracks,IP,Result,ResultError);
+	}
+
+	void VertexFitterLSM::_fitError( const std::vector<TrackState*> & Tracks, InteractionPoint* IP, const Vector3 & Result, Matrix3x3 & ResultError )
+	{
 		//set the total of the covariances to zero so that they can be added as we go
 		ResultError.clear();
 		if (Tracks.size()>1)
@@ -174,7 +202,15 @@ namespace vertex_lcfi { namespace ZVTOP
 			{
 				ResultError += (*i)->vertexErrorContribution(Result);
 			}
-			ResultError = InvertMatrix(ResultError);
+			//The sum is symmetric, so invert through its lower triangle
+			SymMatrix3x3 Sum;
+			for (int Row = 0;Row < 3;++Row)
+				for (int Column = 0;Column <= Row;++Column)
+					Sum(Row,Column) = ResultError(Row,Column);
+			const SymMatrix3x3 Inverse = InvertSymMatrix3x3(Sum);
+			for (int Row = 0;Row < 3;++Row)
+				for (int Column = 0;Column < 3;++Column)
+					ResultError(Row,Column) = Inverse(Row,Column);
 		}
 		else
 			if (IP) ResultError = IP->errorMatrix();
@@ -202,6 +238,31 @@ namespace vertex_lcfi { namespace ZVTOP
 	{
 		return this->valueAt(Vector3(point[0],point[1],point[2]));
 	}
+	
+	void VertexFitterLSM::valuesAt(const std::vector<std::vector<double> > & points, std::vector<double> & values)
+	{
+		std::vector<Vector3> Points;
+		Points.reserve(points.size());
+		for( std::vector<std::vector<double> >::const_iterator iP=points.begin(); iP<points.end(); ++iP )
+			Points.push_back(Vector3((*iP)[0],(*iP)[1],(*iP)[2]));
+		values.assign(points.size(),0.0);
+		if (points.empty())
+			return;
+		
+		//Track by track so each track can carry its swim from one point to the next
+		std::vector<double> Chi2(points.size());
+		for( std::vector<TrackState*>::iterator i=_trackStateList.begin(); i<_trackStateList.end(); i++ )
+		{
+			(*i)->chi2(&Points[0],Points.size(),&Chi2[0]);
+			for (std::size_t iPoint=0; iPoint<Points.size(); ++iPoint)
+				values[iPoint]+=Chi2[iPoint];
+		}
+		
+		//IP as in valueAt
+		if (_trackStateList.size()<2)
+			for (std::size_t iPoint=0; iPoint<Points.size(); ++iPoint)
+				values[iPoint]+=_chi2Contribution( Points[iPoint], _ip );
+	}
 
 	void VertexFitterLSM::setSeed(Vector3 Seed)
 	{
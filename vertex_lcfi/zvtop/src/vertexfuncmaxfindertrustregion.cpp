@@ -0,0 +1,163 @@
+#include "../include/vertexfuncmaxfindertrustregion.h"
+#include "../../util/inc/vector3.h"
+#include "../include/vertexfunction.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace vertex_lcfi { namespace ZVTOP
+{
+	namespace
+	{
+		//Cholesky factor L (packed lower) of the packed symmetric A+Lambda.I, false if not positive definite
+		bool choleskyShifted(const double* A, double Lambda, double* L)
+		{
+			const double L00 = A[0] + Lambda;
+			if (!(L00 > 0.0)) return false;
+			L[0] = std::sqrt(L00);
+			L[1] = A[1]/L[0];
+			const double L11 = A[2] + Lambda - L[1]*L[1];
+			if (!(L11 > 0.0)) return false;
+			L[2] = std::sqrt(L11);
+			L[3] = A[3]/L[0];
+			L[4] = (A[4] - L[3]*L[1])/L[2];
+			const double L22 = A[5] + Lambda - L[3]*L[3] - L[4]*L[4];
+			if (!(L22 > 0.0)) return false;
+			L[5] = std::sqrt(L22);
+			return true;
+		}
+
+		//Solve L.y = b
+		void forwardSubstitute(const double* L, const double* b, double* y)
+		{
+			y[0] = b[0]/L[0];
+			y[1] = (b[1] - L[1]*y[0])/L[2];
+			y[2] = (b[2] - L[3]*y[0] - L[4]*y[1])/L[5];
+		}
+
+		//Solve L^T.x = y
+		void backSubstitute(const double* L, const double* y, double* x)
+		{
+			x[2] = y[2]/L[5];
+			x[1] = (y[1] - L[4]*x[2])/L[2];
+			x[0] = (y[0] - L[1]*x[1] - L[3]*x[2])/L[0];
+		}
+	}
+
+	VertexFuncMaxFinderTrustRegion::VertexFuncMaxFinderTrustRegion(double InitialRadius, double MaxRadius, double Tolerance, int MaxIterations)
+	: _InitialRadius(InitialRadius),_MaxRadius(MaxRadius),_Tolerance(Tolerance),_MaxIterations(MaxIterations)
+	{
+	}
+
+	Vector3 VertexFuncMaxFinderTrustRegion::findNearestMaximum(const Vector3 & StartPoint, VertexFunction* VertexFunction)
+	{
+		//TODO Exception on null function
+		VertexFunction->makeScratch(_Scratch);
+		Vector3 CurrentPos = StartPoint;
+		Vector3 Gradient;
+		SymMatrix3x3 Hessian;
+		double CurrentValue = VertexFunction->valueAt(CurrentPos,Gradient,Hessian,_Scratch);
+		if (Gradient.mag2() == 0.0)
+			return _PlateauStepper.findNearestMaximum(StartPoint,VertexFunction);
+		double Radius = _InitialRadius;
+		int iterations = 0;
+		for (;iterations < _MaxIterations;++iterations)
+		{
+			const Vector3 Step = this->_step(Hessian,Gradient,Radius);
+			const double StepLength = Step.mag();
+			//Flat or at a stationary point
+			if (StepLength == 0.0)
+				break;
+			double Predicted = Gradient.dot(Step);
+			for (int i=0;i<3;++i)
+				for (int j=0;j<3;++j)
+					Predicted += 0.5*Step(i)*Hessian(i,j)*Step(j);
+			if (!(Predicted > 0.0))
+				break;
+
+			Vector3 TrialGradient;
+			SymMatrix3x3 TrialHessian;
+			const Vector3 TrialPos = CurrentPos+Step;
+			const double TrialValue = VertexFunction->valueAt(TrialPos,TrialGradient,TrialHessian,_Scratch);
+
+			//Resize the region on how well the quadratic model predicted the change
+			const double Ratio = (TrialValue-CurrentValue)/Predicted;
+			if (Ratio < 0.25)
+				Radius = 0.25*StepLength;
+			else if (Ratio > 0.75 && StepLength > 0.99*Radius)
+				Radius = std::min(2.0*Radius,_MaxRadius);
+
+			if (TrialValue > CurrentValue)
+			{
+				CurrentPos = TrialPos;
+				CurrentValue = TrialValue;
+				Gradient = TrialGradient;
+				Hessian = TrialHessian;
+				if (StepLength < _Tolerance)
+					break;
+			}
+			else if (Radius < _Tolerance)
+				break;
+		}
+		if (iterations == _MaxIterations) std::cerr << "Max Finding: Trust region too many iterations" << std::endl;
+		return CurrentPos;
+	}
+
+	Vector3 VertexFuncMaxFinderTrustRegion::_step(const SymMatrix3x3 & Hessian, const Vector3 & Gradient, double Radius) const
+	{
+		//Maximising V is minimising -V, solve (A+Lambda.I).Step = Gradient with A = -Hessian
+		//for the smallest Lambda >= 0 that is positive definite and keeps the step in the region
+		double A[6];
+		for (int i=0;i<3;++i)
+			for (int j=0;j<=i;++j)
+				A[i*(i+1)/2+j] = -Hessian(i,j);
+		const double g[3] = {Gradient.x(),Gradient.y(),Gradient.z()};
+		const double GradientLength = Gradient.mag();
+		if (GradientLength == 0.0)
+			return Vector3(0,0,0);
+
+		//Gershgorin bound on the shift that makes A+Lambda.I positive definite, or a
+		//steepest ascent step of the region radius if A is zero
+		double LambdaSafe = GradientLength/Radius;
+		for (int i=0;i<3;++i)
+		{
+			double Bound = -A[i*(i+1)/2+i];
+			for (int j=0;j<3;++j)
+				if (j != i) Bound += std::fabs(A[i>j ? i*(i+1)/2+j : j*(j+1)/2+i]);
+			LambdaSafe = std::max(LambdaSafe,Bound*(1.0+1e-6) + GradientLength/Radius);
+		}
+
+		double L[6],y[3],p[3];
+		double Lambda = 0.0;
+		double LambdaPositive = -1.0;
+		for (int iterations = 0;iterations < 20;++iterations)
+		{
+			if (!choleskyShifted(A,Lambda,L))
+			{
+				//Too small a shift, back towards the last shift known to be positive definite
+				Lambda = (LambdaPositive < 0.0) ? LambdaSafe : 0.5*(Lambda+LambdaPositive);
+				continue;
+			}
+			LambdaPositive = Lambda;
+			forwardSubstitute(L,g,y);
+			backSubstitute(L,y,p);
+			const double Length = std::sqrt(p[0]*p[0]+p[1]*p[1]+p[2]*p[2]);
+			//Newton step inside the region, or close enough to the boundary
+			if ((Lambda == 0.0 && Length <= Radius) || std::fabs(Length-Radius) < 0.1*Radius)
+				break;
+			//Newton iteration on 1/|p(Lambda)| = 1/Radius
+			double q[3];
+			forwardSubstitute(L,p,q);
+			const double LengthQ2 = q[0]*q[0]+q[1]*q[1]+q[2]*q[2];
+			Lambda = std::max(0.0,Lambda + (Length*Length/LengthQ2)*(Length-Radius)/Radius);
+		}
+		if (LambdaPositive < 0.0)
+			return Gradient*(Radius/GradientLength);
+		Vector3 Step(p[0],p[1],p[2]);
+		const double Length = Step.mag();
+		if (Length > Radius)
+			Step = Step*(Radius/Length);
+		return Step;
+	}
+
+}}
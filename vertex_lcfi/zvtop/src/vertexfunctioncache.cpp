@@ -0,0 +1,101 @@
+#include "../include/vertexfunctioncache.h"
+#include <cmath>
+#include <cstring>
+
+namespace vertex_lcfi { namespace ZVTOP
+{
+	namespace
+	{
+		const std::size_t InitialSlots = 256;
+	}
+
+	VertexFunctionCache::VertexFunctionCache(double GridSize, std::size_t MaxEntries)
+	: _GridSize(GridSize),_InvGridSize(GridSize > 0.0 ? 1.0/GridSize : 0.0),_MaxEntries(MaxEntries)
+	{
+		_Table.resize(InitialSlots);
+		this->clear();
+	}
+
+	void VertexFunctionCache::_key(const Vector3 & Point, long long* Key) const
+	{
+		const double Coord[3] = {Point.x(),Point.y(),Point.z()};
+		for (int i=0;i<3;++i)
+		{
+			if (_GridSize > 0.0)
+				Key[i] = (long long)std::floor(Coord[i]*_InvGridSize);
+			else
+				std::memcpy(&Key[i],&Coord[i],sizeof(double));
+		}
+	}
+
+	std::size_t VertexFunctionCache::_slot(const long long* Key) const
+	{
+		unsigned long long Hash = (unsigned long long)Key[0]*0x9E3779B97F4A7C15ULL;
+		Hash ^= (unsigned long long)Key[1]*0xC2B2AE3D27D4EB4FULL;
+		Hash ^= (unsigned long long)Key[2]*0x165667B19E3779F9ULL;
+		Hash ^= Hash >> 29;
+		return std::size_t(Hash) & (_Table.size()-1);
+	}
+
+	bool VertexFunctionCache::find(const Vector3 & Point, double & Value)
+	{
+		long long Key[3];
+		this->_key(Point,Key);
+		for (std::size_t Slot = this->_slot(Key);_Table[Slot].Used;Slot = (Slot+1) & (_Table.size()-1))
+		{
+			const Entry & E = _Table[Slot];
+			if (E.Key[0] == Key[0] && E.Key[1] == Key[1] && E.Key[2] == Key[2])
+			{
+				Value = E.Value;
+				++_Hits;
+				return true;
+			}
+		}
+		++_Misses;
+		return false;
+	}
+
+	void VertexFunctionCache::insert(const Vector3 & Point, double Value)
+	{
+		if (_Size >= _MaxEntries)
+			this->clear();
+		if (2*(_Size+1) > _Table.size())
+			this->_grow();
+		long long Key[3];
+		this->_key(Point,Key);
+		std::size_t Slot = this->_slot(Key);
+		while (_Table[Slot].Used)
+			Slot = (Slot+1) & (_Table.size()-1);
+		Entry & E = _Table[Slot];
+		E.Key[0] = Key[0];
+		E.Key[1] = Key[1];
+		E.Key[2] = Key[2];
+		E.Value = Value;
+		E.Used = true;
+		++_Size;
+	}
+
+	void VertexFunctionCache::clear()
+	{
+		for (std::vector<Entry>::iterator iE = _Table.begin();iE != _Table.end();++iE)
+			iE->Used = false;
+		_Size = 0;
+	}
+
+	void VertexFunctionCache::_grow()
+	{
+		std::vector<Entry> Old(2*_Table.size());
+		Old.swap(_Table);
+		this->clear();
+		for (std::vector<Entry>::const_iterator iE = Old.begin();iE != Old.end();++iE)
+		{
+			if (!iE->Used)
+				continue;
+			std::size_t Slot = this->_slot(iE->Key);
+			while (_Table[Slot].Used)
+				Slot = (Slot+1) & (_Table.size()-1);
+			_Table[Slot] = *iE;
+			++_Size;
+		}
+	}
+}}
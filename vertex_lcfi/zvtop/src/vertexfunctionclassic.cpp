@@ -5,9 +5,79 @@
 #include "../include/gaussellipsoid.h"
 #include "../include/interactionpoint.h"
 #include "../../util/inc/vector3.h"
+#include <cmath>
+#include <mutex>
+#include <set>
 
 namespace vertex_lcfi { namespace ZVTOP
 {		
+	namespace
+	{
+		//The gaussians of GaussTube and GaussEllipsoid in float, for ValidatePrecision
+		float tubeInFloat(const SymMatrix2x2 & InverseCovar, double RPhi, double Z)
+		{
+			const double* m = &InverseCovar.data()[0];
+			const float r0 = float(RPhi);
+			const float r1 = float(Z);
+			const float m0 = float(m[0]);
+			const float m1 = float(m[1]);
+			const float m2 = float(m[2]);
+			return std::exp(-0.5f * (r0*(m0*r0 + m1*r1) + r1*(m1*r0 + m2*r1)));
+		}
+		
+		float ellipsoidInFloat(const Matrix3x3 & InverseError, float r0, float r1, float r2)
+		{
+			const double* m = &InverseError.data()[0];
+			const float t0 = float(m[0])*r0 + float(m[1])*r1 + float(m[2])*r2;
+			const float t1 = float(m[3])*r0 + float(m[4])*r1 + float(m[5])*r2;
+			const float t2 = float(m[6])*r0 + float(m[7])*r1 + float(m[8])*r2;
+			return std::exp(-0.5f * (r0*t0 + r1*t1 + r2*t2));
+		}
+		
+		void mergeValidation(PrecisionValidation & Into, const PrecisionValidation & From)
+		{
+			Into.Evaluations += From.Evaluations;
+			Into.ThresholdDisagreements += From.ThresholdDisagreements;
+			if (From.MaxAbsDeviation > Into.MaxAbsDeviation)
+				Into.MaxAbsDeviation = From.MaxAbsDeviation;
+			if (From.MaxRelDeviation > Into.MaxRelDeviation)
+				Into.MaxRelDeviation = From.MaxRelDeviation;
+		}
+
+		//The deviations of every thread, as evaluations run on the task pool's workers too
+		struct ValidationRegistry
+		{
+			std::mutex Mutex;
+			std::set<PrecisionValidation*> Running;
+			PrecisionValidation Finished = {0,0,0.0,0.0};
+		};
+
+		ValidationRegistry & validationRegistry()
+		{
+			static ValidationRegistry Registry;
+			return Registry;
+		}
+
+		//A thread's deviations, added to the finished threads' when it exits
+		struct ThreadValidation
+		{
+			PrecisionValidation Validation = {0,0,0.0,0.0};
+			ThreadValidation()
+			{
+				ValidationRegistry & Registry = validationRegistry();
+				std::lock_guard<std::mutex> Lock(Registry.Mutex);
+				Registry.Running.insert(&Validation);
+			}
+			~ThreadValidation()
+			{
+				ValidationRegistry & Registry = validationRegistry();
+				std::lock_guard<std::mutex> Lock(Registry.Mutex);
+				mergeValidation(Registry.Finished,Validation);
+				Registry.Running.erase(&Validation);
+			}
+		};
+	}
+
 	VertexFunctionClassic::VertexFunctionClassic(std::vector<Track*> & Tracks, const double Kip, const double Kalpha, const Vector3 & JetAxis)
 	{
 		_Kip=Kip;
@@ -22,6 +92,7 @@ namespace vertex_lcfi { namespace ZVTOP
 			_ElementsNewedByThis.push_back(element);
 		}
 		_Ellipsoid=0;
+		this->makeScratch(_Scratch);
 	
 	}
 
@@ -46,19 +117,72 @@ namespace vertex_lcfi { namespace ZVTOP
 		}
 		else
 			_Ellipsoid = 0;
+		this->makeScratch(_Scratch);
 	
 	}
 
 	
 	VertexFunctionClassic::~VertexFunctionClassic()
 	{
+		this->disableCache();
 		for (std::vector<VertexFunctionElement*>::iterator iElement = _ElementsNewedByThis.begin();iElement != _ElementsNewedByThis.end();++iElement)
 			delete *iElement;
 	}
 	
 	
 
+	void VertexFunctionClassic::makeScratch(VertexFunctionScratch & Scratch) const
+	{
+		Scratch.TrackStates.clear();
+		Scratch.TrackStates.reserve(_Tubes.size());
+		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube)
+			Scratch.TrackStates.push_back((*iTube)->makeScratch());
+	}
+
 	double VertexFunctionClassic::valueAt(const Vector3 & Point) const
+	{
+		//_Scratch holds _Cache if there is one
+		return this->valueAt(Point,_Scratch);
+	}
+	
+	double VertexFunctionClassic::valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const
+	{
+		if (!Scratch.Cache)
+			return this->_valueAt(Point,Scratch);
+		double Value;
+		if (!Scratch.Cache->find(Point,Value))
+		{
+			Value = this->_valueAt(Point,Scratch);
+			Scratch.Cache->insert(Point,Value);
+		}
+		return Value;
+	}
+	
+	double VertexFunctionClassic::_valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const
+	{
+		switch (_Precision)
+		{
+			case ValidatePrecision:
+			{
+				const double Value = _valueAtDouble(Point,Scratch);
+				const float SingleValue = _valueAtSingle(Point,Scratch);
+				PrecisionValidation & Validation = _validation();
+				const double Deviation = fabs(Value - double(SingleValue));
+				++Validation.Evaluations;
+				if ((Value > 0.001) != (SingleValue > 0.001f))
+					++Validation.ThresholdDisagreements;
+				if (Deviation > Validation.MaxAbsDeviation)
+					Validation.MaxAbsDeviation = Deviation;
+				if (Value > 0.001 && Deviation/Value > Validation.MaxRelDeviation)
+					Validation.MaxRelDeviation = Deviation/Value;
+				return Value;
+			}
+			default:
+				return _valueAtDouble(Point,Scratch);
+		}
+	}
+	
+	double VertexFunctionClassic::_valueAtDouble(const Vector3 & Point, VertexFunctionScratch & Scratch) const
 	{
 		double SumOfTubes = 0;
 		double SumOfSquaredTubes = 0;
@@ -67,9 +191,12 @@ namespace vertex_lcfi { namespace ZVTOP
 		//TODO make other constants parameters
 	
 		//Now add up the tubes
-		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube)
+		std::vector<TrackState>::iterator iState = Scratch.TrackStates.begin();
+		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube,++iState)
 		{
-			double Tube = (*iTube)->valueAt(Point);
+			if (_CullEpsilon > 0.0 && (*iTube)->chiSquaredLowerBound(Point) > _CullChiSquared)
+				continue;
+			double Tube = (*iTube)->valueAt(Point,*iState);
 			SumOfTubes += Tube;
 			SumOfSquaredTubes += (Tube*Tube);
 		}
@@ -105,17 +232,298 @@ namespace vertex_lcfi { namespace ZVTOP
 			return 0;
 	}
 	
-	Matrix3x3 VertexFunctionClassic::firstDervAt(const Vector3& /*Point*/) const
+	float VertexFunctionClassic::_valueAtSingle(const Vector3 & Point, VertexFunctionScratch & Scratch) const
+	{
+		//As _valueAtDouble with the gaussians, the sums and the jet axis term in float
+		float SumOfTubes = 0;
+		float SumOfSquaredTubes = 0;
+		
+		std::vector<TrackState>::iterator iState = Scratch.TrackStates.begin();
+		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube,++iState)
+		{
+			if (_CullEpsilon > 0.0 && (*iTube)->chiSquaredLowerBound(Point) > _CullChiSquared)
+				continue;
+			double RPhi,Z;
+			(*iTube)->residual(Point,*iState,RPhi,Z);
+			float Tube = tubeInFloat((*iTube)->inversePositionCovarMatrix(),RPhi,Z);
+			SumOfTubes += Tube;
+			SumOfSquaredTubes += (Tube*Tube);
+		}
+		
+		float IPValue = 0;
+		float dlong = 0;
+		float dtran = 0;
+		if (_Ellipsoid)
+		{
+			const Vector3 & IPPosition = _Ellipsoid->ip()->position();
+			const float dx = float(Point.x()-IPPosition.x());
+			const float dy = float(Point.y()-IPPosition.y());
+			const float dz = float(Point.z()-IPPosition.z());
+			IPValue = ellipsoidInFloat(_Ellipsoid->ip()->inverseErrorMatrix(),dx,dy,dz);
+			dlong = (dx*float(_JetAxis.x()) + dy*float(_JetAxis.y()) + dz*float(_JetAxis.z())) / float(_JetAxis.mag());
+			
+			if (dlong < -0.01f)    //100 Micron behind the ip
+				return -1.0f;
+			
+			const float dmag2 = dx*dx + dy*dy + dz*dz;
+			dtran = std::sqrt(dmag2 - dlong*dlong);
+		}
+		
+		const float Kip = float(_Kip);
+		if (SumOfTubes > 0)
+		{
+			const float Value = (Kip*IPValue) + SumOfTubes - ( ((Kip*IPValue*IPValue)+SumOfSquaredTubes) / ((Kip*IPValue)+SumOfTubes));
+			if (dtran > 0.005f) //50 Micron
+			{
+				const float alpha = std::acos((dlong + 0.01f) / std::sqrt(((dlong + 0.01f)*(dlong + 0.01f)) + (dtran - 0.005f)*(dtran - 0.005f)));
+				return std::exp(-float(_Kalpha)*alpha*alpha)*Value;
+			}
+			return Value;
+		}
+		return 0;
+	}
+	
+	void VertexFunctionClassic::setPrecision(VertexFunctionPrecision Precision)
+	{
+		_Precision = Precision;
+		if (_Cache)
+			_Cache->clear();
+	}
+	
+	VertexFunctionPrecision VertexFunctionClassic::precision() const
+	{
+		return _Precision;
+	}
+	
+	void VertexFunctionClassic::setCullEpsilon(double Epsilon)
+	{
+		_CullEpsilon = Epsilon;
+		_CullChiSquared = (Epsilon > 0.0) ? -2.0*log(Epsilon) : HUGE_VAL;
+		if (_Cache)
+			_Cache->clear();
+	}
+	
+	void VertexFunctionClassic::enableCache(double GridSize)
+	{
+		this->disableCache();
+		_Cache = new VertexFunctionCache(GridSize);
+		_Scratch.Cache = _Cache;
+	}
+	
+	void VertexFunctionClassic::disableCache()
+	{
+		if (!_Cache)
+			return;
+		countCacheLookups(*_Cache);
+		delete _Cache;
+		_Cache = 0;
+		_Scratch.Cache = 0;
+	}
+	
+	void VertexFunctionClassic::countCacheLookups(const VertexFunctionCache & Cache)
+	{
+		CacheStatistics & Statistics = _cacheStatistics();
+		Statistics.Hits += Cache.hits();
+		Statistics.Misses += Cache.misses();
+	}
+	
+	const VertexFunctionCache* VertexFunctionClassic::cache() const
+	{
+		return _Cache;
+	}
+	
+	CacheStatistics & VertexFunctionClassic::_cacheStatistics()
+	{
+		static thread_local CacheStatistics Statistics = {0,0};
+		return Statistics;
+	}
+	
+	const CacheStatistics & VertexFunctionClassic::cacheStatistics()
+	{
+		return _cacheStatistics();
+	}
+	
+	void VertexFunctionClassic::resetCacheStatistics()
+	{
+		CacheStatistics & Statistics = _cacheStatistics();
+		Statistics.Hits = 0;
+		Statistics.Misses = 0;
+	}
+	
+	double VertexFunctionClassic::cullEpsilon() const
+	{
+		return _CullEpsilon;
+	}
+	
+	PrecisionValidation & VertexFunctionClassic::_validation()
 	{
-	//	TODO Implement if needed this funcion could be one class up
-		return Matrix3x3();
+		static thread_local ThreadValidation Validation;
+		return Validation.Validation;
+	}
+	
+	PrecisionValidation VertexFunctionClassic::precisionValidation()
+	{
+		ValidationRegistry & Registry = validationRegistry();
+		std::lock_guard<std::mutex> Lock(Registry.Mutex);
+		PrecisionValidation Merged = Registry.Finished;
+		for (std::set<PrecisionValidation*>::const_iterator iValidation = Registry.Running.begin();iValidation != Registry.Running.end();++iValidation)
+			mergeValidation(Merged,**iValidation);
+		return Merged;
+	}
+	
+	void VertexFunctionClassic::resetPrecisionValidation()
+	{
+		const PrecisionValidation Zero = {0,0,0.0,0.0};
+		ValidationRegistry & Registry = validationRegistry();
+		std::lock_guard<std::mutex> Lock(Registry.Mutex);
+		Registry.Finished = Zero;
+		for (std::set<PrecisionValidation*>::iterator iValidation = Registry.Running.begin();iValidation != Registry.Running.end();++iValidation)
+			**iValidation = Zero;
+	}
+	
+	Vector3 VertexFunctionClassic::firstDervAt(const Vector3& Point) const
+	{
+		Vector3 Gradient;
+		this->_derivativesAt(Point,_Scratch,Gradient,0);
+		return Gradient;
 	}
 
 	
-	Matrix3x3 VertexFunctionClassic::secondDervAt(const Vector3& /*Point*/) const
+	SymMatrix3x3 VertexFunctionClassic::secondDervAt(const Vector3& Point) const
+	{
+		Vector3 Gradient;
+		SymMatrix3x3 Hessian;
+		this->_derivativesAt(Point,_Scratch,Gradient,&Hessian);
+		return Hessian;
+	}
+	
+	double VertexFunctionClassic::valueAt(const Vector3 & Point, Vector3 & Gradient) const
+	{
+		return this->_derivativesAt(Point,_Scratch,Gradient,0);
+	}
+	
+	double VertexFunctionClassic::valueAt(const Vector3 & Point, Vector3 & Gradient, VertexFunctionScratch & Scratch) const
+	{
+		return this->_derivativesAt(Point,Scratch,Gradient,0);
+	}
+	
+	double VertexFunctionClassic::valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 & Hessian, VertexFunctionScratch & Scratch) const
+	{
+		return this->_derivativesAt(Point,Scratch,Gradient,&Hessian);
+	}
+	
+	double VertexFunctionClassic::_derivativesAt(const Vector3 & Point, VertexFunctionScratch & Scratch, Vector3 & Gradient, SymMatrix3x3 * Hessian) const
 	{
-	//	TODO Implement if needed this funcion could be one class up
-		return Matrix3x3();
+		//As _valueAtDouble, carrying the derivatives of each term along. With S1 = Kip.f0+sum(f)
+		//and S2 = Kip.f0^2+sum(f^2) the function is U = S1-S2/S1, times exp(-Kalpha.alpha^2)
+		//away from the jet axis.
+		Gradient.clear();
+		if (Hessian)
+			Hessian->clear();
+		
+		double SumOfTubes = 0;
+		double SumOfSquaredTubes = 0;
+		Vector3 GradS1(0,0,0);
+		Vector3 GradS2(0,0,0);
+		SymMatrix3x3 HessS1;
+		SymMatrix3x3 HessS2;
+		HessS1.clear();
+		HessS2.clear();
+		Vector3 GradF;
+		SymMatrix3x3 HessF;
+		
+		std::vector<TrackState>::iterator iState = Scratch.TrackStates.begin();
+		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube,++iState)
+		{
+			if (_CullEpsilon > 0.0 && (*iTube)->chiSquaredLowerBound(Point) > _CullChiSquared)
+				continue;
+			double Tube = (*iTube)->valueAt(Point,*iState,GradF,Hessian ? &HessF : 0);
+			SumOfTubes += Tube;
+			SumOfSquaredTubes += (Tube*Tube);
+			GradS1 += GradF;
+			GradS2 += GradF*(2.0*Tube);
+			if (Hessian)
+			{
+				HessS1 += HessF;
+				HessS2 += HessF*(2.0*Tube);
+				addOuterProduct(HessS2, 2.0, GradF);
+			}
+		}
+		
+		double IPValue = 0;
+		double dlong = 0;
+		double dtran = 0;
+		if (_Ellipsoid)
+		{
+			IPValue = _Ellipsoid->valueAt(Point,GradF,Hessian ? &HessF : 0);
+			GradS1 += GradF*_Kip;
+			GradS2 += GradF*(2.0*_Kip*IPValue);
+			if (Hessian)
+			{
+				HessS1 += HessF*_Kip;
+				HessS2 += HessF*(2.0*_Kip*IPValue);
+				addOuterProduct(HessS2, 2.0*_Kip, GradF);
+			}
+			
+			dlong = Point.subtract(_Ellipsoid->ip()->position()).dot(_JetAxis) / _JetAxis.mag();
+			if (dlong < -0.01)    //100 Micron behind the ip
+				return -1.0;
+			const double dmag = _Ellipsoid->ip()->distanceTo(Point);
+			dtran = sqrt(dmag*dmag - dlong*dlong);
+		}
+		if (!(SumOfTubes > 0))
+			return 0;
+		
+		const double S1 = (_Kip*IPValue) + SumOfTubes;
+		const double S2 = (_Kip*IPValue*IPValue)+SumOfSquaredTubes;
+		const double U = S1 - (S2 / S1);
+		const Vector3 GradU = GradS1 - GradS2/S1 + GradS1*(S2/(S1*S1));
+		SymMatrix3x3 HessU;
+		if (Hessian)
+		{
+			HessU = HessS1*(1.0 + S2/(S1*S1)) - HessS2/S1;
+			addOuterProduct(HessU, 1.0/(S1*S1), GradS1, GradS2);
+			addOuterProduct(HessU, -2.0*S2/(S1*S1*S1), GradS1);
+		}
+		
+		//Check if we are outside tube and add on kalpha adjustment if not
+		if (dtran > 0.005) //50 Micron
+		{
+			//alpha = atan2(b,a) with a = dlong+0.01 along the jet axis and b = dtran-0.005 across it
+			const double a = dlong + 0.01;
+			const double b = dtran - 0.005;
+			const double Rho2 = (a*a) + (b*b);
+			const double alpha = acos(a / sqrt(Rho2));
+			const double Factor = exp(-_Kalpha*alpha*alpha);
+			
+			const Vector3 Axis = _JetAxis / _JetAxis.mag();
+			const Vector3 Across = (Point - _Ellipsoid->ip()->position() - Axis*dlong) / dtran;
+			const Vector3 GradAlpha = (Across*a - Axis*b) / Rho2;
+			const Vector3 GradFactor = GradAlpha*(-2.0*_Kalpha*alpha*Factor);
+			
+			Gradient = GradU*Factor + GradFactor*U;
+			if (Hessian)
+			{
+				//b has second derivative (I - Axis.Axis - Across.Across)/dtran, a has none
+				SymMatrix3x3 HessAlpha;
+				HessAlpha.clear();
+				HessAlpha(0,0) = HessAlpha(1,1) = HessAlpha(2,2) = a/(dtran*Rho2);
+				addOuterProduct(HessAlpha, -a/(dtran*Rho2), Axis);
+				addOuterProduct(HessAlpha, -a/(dtran*Rho2), Across);
+				addOuterProduct(HessAlpha, -1.0/(Rho2*Rho2), Across*a - Axis*b, Across*b + Axis*a);
+				
+				SymMatrix3x3 HessFactor = HessAlpha*(-2.0*_Kalpha*alpha*Factor);
+				addOuterProduct(HessFactor, Factor*_Kalpha*(4.0*_Kalpha*alpha*alpha - 2.0), GradAlpha);
+				
+				*Hessian = HessU*Factor + HessFactor*U;
+				addOuterProduct(*Hessian, 1.0, GradU, GradFactor);
+			}
+			return Factor*U;
+		}
+		Gradient = GradU;
+		if (Hessian)
+			*Hessian = HessU;
+		return U;
 	}
 
 	
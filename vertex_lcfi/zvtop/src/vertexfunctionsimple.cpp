@@ -17,6 +17,7 @@ namespace vertex_lcfi { namespace ZVTOP
 			_ElementsNewedByThis.push_back(element);
 		}
 		_Ellipsoid = 0;
+		this->makeScratch(_Scratch);
 	
 	}
 
@@ -38,6 +39,7 @@ namespace vertex_lcfi { namespace ZVTOP
 		}
 		else
 			_Ellipsoid = 0;
+		this->makeScratch(_Scratch);
 	
 	}
 
@@ -48,13 +50,27 @@ namespace vertex_lcfi { namespace ZVTOP
 			delete *iElement;
 	}
 	
+	void VertexFunctionSimple::makeScratch(VertexFunctionScratch & Scratch) const
+	{
+		Scratch.TrackStates.clear();
+		Scratch.TrackStates.reserve(_Tubes.size());
+		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube)
+			Scratch.TrackStates.push_back((*iTube)->makeScratch());
+	}
+
 	double VertexFunctionSimple::valueAt(const Vector3 & Point) const
+	{
+		return this->valueAt(Point,_Scratch);
+	}
+	
+	double VertexFunctionSimple::valueAt(const Vector3 & Point, VertexFunctionScratch & Scratch) const
 	{
 		double SumOfTubes = 0;
 		double SumOfSquaredTubes = 0;
-		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube)
+		std::vector<TrackState>::iterator iState = Scratch.TrackStates.begin();
+		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube,++iState)
 		{
-			double Tube = (*iTube)->valueAt(Point);
+			double Tube = (*iTube)->valueAt(Point,*iState);
 			SumOfTubes += Tube;
 			SumOfSquaredTubes += (Tube*Tube);
 		}
@@ -67,17 +83,91 @@ namespace vertex_lcfi { namespace ZVTOP
 			return 0;
 	}
 	
-	Matrix3x3 VertexFunctionSimple::firstDervAt(const Vector3& /*Point*/) const
+	Vector3 VertexFunctionSimple::firstDervAt(const Vector3& Point) const
 	{
-	//	TODO Implement if needed this funcion could be one class up
-		return Matrix3x3();
+		Vector3 Gradient;
+		this->_derivativesAt(Point,_Scratch,Gradient,0);
+		return Gradient;
 	}
 
 	
-	Matrix3x3 VertexFunctionSimple::secondDervAt(const Vector3&/*Point*/) const
+	SymMatrix3x3 VertexFunctionSimple::secondDervAt(const Vector3& Point) const
+	{
+		Vector3 Gradient;
+		SymMatrix3x3 Hessian;
+		this->_derivativesAt(Point,_Scratch,Gradient,&Hessian);
+		return Hessian;
+	}
+	
+	double VertexFunctionSimple::valueAt(const Vector3 & Point, Vector3 & Gradient, VertexFunctionScratch & Scratch) const
+	{
+		return this->_derivativesAt(Point,Scratch,Gradient,0);
+	}
+	
+	double VertexFunctionSimple::valueAt(const Vector3 & Point, Vector3 & Gradient, SymMatrix3x3 & Hessian, VertexFunctionScratch & Scratch) const
+	{
+		return this->_derivativesAt(Point,Scratch,Gradient,&Hessian);
+	}
+	
+	double VertexFunctionSimple::_derivativesAt(const Vector3 & Point, VertexFunctionScratch & Scratch, Vector3 & Gradient, SymMatrix3x3 * Hessian) const
 	{
-	//	TODO Implement if needed this funcion could be one class up
-		return Matrix3x3();
+		//With S1 = f0+sum(f) and S2 = f0^2+sum(f^2) the function is S1-S2/S1
+		Gradient.clear();
+		if (Hessian)
+			Hessian->clear();
+		
+		double SumOfTubes = 0;
+		double SumOfSquaredTubes = 0;
+		Vector3 GradS1(0,0,0);
+		Vector3 GradS2(0,0,0);
+		SymMatrix3x3 HessS1;
+		SymMatrix3x3 HessS2;
+		HessS1.clear();
+		HessS2.clear();
+		Vector3 GradF;
+		SymMatrix3x3 HessF;
+		
+		std::vector<TrackState>::iterator iState = Scratch.TrackStates.begin();
+		for (std::vector<GaussTube*>::const_iterator iTube = _Tubes.begin();iTube != _Tubes.end();++iTube,++iState)
+		{
+			double Tube = (*iTube)->valueAt(Point,*iState,GradF,Hessian ? &HessF : 0);
+			SumOfTubes += Tube;
+			SumOfSquaredTubes += (Tube*Tube);
+			GradS1 += GradF;
+			GradS2 += GradF*(2.0*Tube);
+			if (Hessian)
+			{
+				HessS1 += HessF;
+				HessS2 += HessF*(2.0*Tube);
+				addOuterProduct(HessS2, 2.0, GradF);
+			}
+		}
+		if (!(SumOfTubes > 0))
+			return 0;
+		double IPValue = 0;
+		if (_Ellipsoid)
+		{
+			IPValue = _Ellipsoid->valueAt(Point,GradF,Hessian ? &HessF : 0);
+			GradS1 += GradF;
+			GradS2 += GradF*(2.0*IPValue);
+			if (Hessian)
+			{
+				HessS1 += HessF;
+				HessS2 += HessF*(2.0*IPValue);
+				addOuterProduct(HessS2, 2.0, GradF);
+			}
+		}
+		const double S1 = IPValue + SumOfTubes;
+		const double S2 = (IPValue*IPValue)+SumOfSquaredTubes;
+		
+		Gradient = GradS1 - GradS2/S1 + GradS1*(S2/(S1*S1));
+		if (Hessian)
+		{
+			*Hessian = HessS1*(1.0 + S2/(S1*S1)) - HessS2/S1;
+			addOuterProduct(*Hessian, 1.0/(S1*S1), GradS1, GradS2);
+			addOuterProduct(*Hessian, -2.0*S2/(S1*S1*S1), GradS1);
+		}
+		return S1 - (S2 / S1);
 	}
 
 	
@@ -0,0 +1,89 @@
+#include "../include/vertexresolverbisection.h"
+#include "../../util/inc/vector3.h"
+#include "../include/vertexfunction.h"
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+namespace vertex_lcfi { namespace ZVTOP
+{
+	VertexResolverBisection::VertexResolverBisection(int NumSteps, int Refinements)
+	: _NumSteps(std::max(2,NumSteps)),_Refinements(std::max(0,Refinements))
+	{
+		//Breadth first bisection of the step indices 0 to _NumSteps, each interval
+		//contributing its midpoint, visits every interior index once coarse to fine
+		std::deque<std::pair<int,int> > Intervals;
+		Intervals.push_back(std::make_pair(0,_NumSteps));
+		while (!Intervals.empty())
+		{
+			const int Low = Intervals.front().first;
+			const int High = Intervals.front().second;
+			Intervals.pop_front();
+			if (High-Low < 2)
+				continue;
+			const int Mid = (Low+High)/2;
+			_SampleOrder.push_back(Mid);
+			Intervals.push_back(std::make_pair(Low,Mid));
+			Intervals.push_back(std::make_pair(Mid,High));
+		}
+	}
+
+	bool VertexResolverBisection::areResolved(const Vector3& Vertex1, const Vector3& Vertex2, VertexFunction const * VF, const double Threshold) const
+	{
+		//Same cut as VertexResolverEqualSteps, before evaluating anything
+		if (Vertex1.distanceTo(Vertex2)<(10.0/1000.0)) return 0;
+		return this->areResolved(Vertex1,Vertex2,VF->valueAt(Vertex1),VF->valueAt(Vertex2),VF,Threshold);
+	}
+
+	bool VertexResolverBisection::areResolved(const Vector3& Vertex1, const Vector3& Vertex2, double Vertex1Value, double Vertex2Value, VertexFunction const * VF, const double Threshold) const
+	{
+		//TODO Check for null pointers
+		const Vector3 ResolveLine = Vertex2-Vertex1;
+		if (ResolveLine.mag()<(10.0/1000.0)) return 0;
+		const Vector3 Step = ResolveLine/_NumSteps;
+
+		const double VertexMin = std::min(Vertex1Value,Vertex2Value);
+		if (!(VertexMin > 0))   //Check for bad denominator
+			return 0;
+
+		int LowestIndex = 0;
+		double LowestValue = 0.0;
+		for (std::vector<int>::const_iterator iIndex = _SampleOrder.begin();iIndex != _SampleOrder.end();++iIndex)
+		{
+			const double Value = VF->valueAt(Vertex1+Step*(*iIndex));
+			if ((Value/VertexMin) < Threshold)
+				return 1;
+			if (iIndex == _SampleOrder.begin() || Value < LowestValue)
+			{
+				LowestIndex = *iIndex;
+				LowestValue = Value;
+			}
+		}
+
+		//Close in on the lowest sample, keeping within the line
+		double Position = LowestIndex;
+		double Width = 0.5;
+		for (int i = 0;i < _Refinements;++i,Width *= 0.5)
+		{
+			const double Below = std::max(0.0,Position-Width);
+			const double Above = std::min(double(_NumSteps),Position+Width);
+			const double BelowValue = VF->valueAt(Vertex1+Step*Below);
+			const double AboveValue = VF->valueAt(Vertex1+Step*Above);
+			if ((BelowValue/VertexMin) < Threshold || (AboveValue/VertexMin) < Threshold)
+				return 1;
+			if (BelowValue < LowestValue && BelowValue <= AboveValue)
+			{
+				Position = Below;
+				LowestValue = BelowValue;
+			}
+			else if (AboveValue < LowestValue)
+			{
+				Position = Above;
+				LowestValue = AboveValue;
+			}
+		}
+
+		//None of them passed the criteria so we are unresolved
+		return 0;
+	}
+}}
@@ -9,6 +9,13 @@ namespace vertex_lcfi { namespace ZVTOP
 	}
 
 	bool VertexResolverEqualSteps::areResolved(const Vector3& Vertex1, const Vector3& Vertex2, VertexFunction const * VF, const double Threshold) const
+	{
+		//TODO Cut found in FORTRAN keep?
+		if (Vertex1.distanceTo(Vertex2)<(10.0/1000.0)) return 0;
+		return this->areResolved(Vertex1,Vertex2,VF->valueAt(Vertex1),VF->valueAt(Vertex2),VF,Threshold);
+	}
+
+	bool VertexResolverEqualSteps::areResolved(const Vector3& Vertex1, const Vector3& Vertex2, double Vertex1Value, double Vertex2Value, VertexFunction const * VF, const double Threshold) const
 	{
 		//TODO Check for null pointers
 		//NB Number of steps hardwired - could be in constructor or function call
@@ -23,8 +30,7 @@ namespace vertex_lcfi { namespace ZVTOP
 		if (Step.mag()>0)
 		{
 			//Find which vertex has min VF
-			double VertexMin = VF->valueAt(Vertex1);
-			double Vertex2Value = VF->valueAt(Vertex2);
+			double VertexMin = Vertex1Value;
 			if (Vertex2Value < VertexMin)
 				VertexMin = Vertex2Value;
 			